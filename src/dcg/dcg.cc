@@ -33,7 +33,11 @@
  */
 
 #include <fstream>
+#include <sstream>
 #include <utility>
+#include <algorithm>
+#include <cmath>
+#include <boost/functional/hash.hpp>
 
 #include "h2sl/grounding_set.h"
 #include "h2sl/region.h"
@@ -44,110 +48,136 @@ using namespace std;
 using namespace h2sl;
 
 DCG::
-DCG() : _search_spaces(),
-        _correspondence_variables(),
+DCG() : _search_space( NULL ),
+        _search_space_cache(),
+        _search_space_cache_size( 4 ),
+        _search_space_filter(),
+        _adaptive_constraints( false ),
+        _adaptive_constraints_confidence( 0.5 ),
+        _lexical_object_pruning( false ),
+        _lexical_object_filter(),
+        _min_beam_width( 1 ),
+        _beam_mass( 1.0 ),
         _solutions(),
-        _root( NULL ) {
+        _root( NULL ),
+        _truncated( false ),
+        _parse_index( 0 ),
+        _num_abandoned_parses( 0 ),
+        _subtree_memo(),
+        _num_reused_subtrees( 0 ),
+        _solution_cache(),
+        _incremental( false ),
+        _num_scored( 0 ),
+        _canonical_constraints( false ) {
 
 }
 
 DCG::
 ~DCG() {
-
+  clear_search_spaces();
 }
 
 DCG::
-DCG( const DCG& other ) : _search_spaces( other._search_spaces ),
-                          _correspondence_variables( other._correspondence_variables ),
+DCG( const DCG& other ) : _search_space( NULL ),
+                          _search_space_cache(),
+                          _search_space_cache_size( other._search_space_cache_size ),
+                          _search_space_filter( other._search_space_filter ),
+                          _adaptive_constraints( other._adaptive_constraints ),
+                          _adaptive_constraints_confidence( other._adaptive_constraints_confidence ),
+                          _lexical_object_pruning( other._lexical_object_pruning ),
+                          _lexical_object_filter( other._lexical_object_filter ),
+                          _min_beam_width( other._min_beam_width ),
+                          _beam_mass( other._beam_mass ),
                           _solutions( other._solutions ),
-                          _root( other._root ) {
-
+                          _root( other._root ),
+                          _truncated( other._truncated ),
+                          _parse_index( other._parse_index ),
+                          _num_abandoned_parses( other._num_abandoned_parses ),
+                          _subtree_memo( other._subtree_memo ),
+                          _num_reused_subtrees( other._num_reused_subtrees ),
+                          _solution_cache( other._solution_cache.size() ),
+                          _incremental( other._incremental ),
+                          _num_scored( other._num_scored ),
+                          _canonical_constraints( other._canonical_constraints ) {
+  for( list< Search_Space* >::const_iterator it = other._search_space_cache.begin(); it != other._search_space_cache.end(); it++ ){
+    _search_space_cache.push_back( new Search_Space( **it ) );
+    if( *it == other._search_space ){
+      _search_space = _search_space_cache.back();
+    }
+  }
 }
 
 DCG&
 DCG::
 operator=( const DCG& other ) {
-  _search_spaces = other._search_spaces;
-  _correspondence_variables = other._correspondence_variables;
+  clear_search_spaces();
+  for( list< Search_Space* >::const_iterator it = other._search_space_cache.begin(); it != other._search_space_cache.end(); it++ ){
+    _search_space_cache.push_back( new Search_Space( **it ) );
+    if( *it == other._search_space ){
+      _search_space = _search_space_cache.back();
+    }
+  }
+  _search_space_cache_size = other._search_space_cache_size;
+  _search_space_filter = other._search_space_filter;
+  _adaptive_constraints = other._adaptive_constraints;
+  _adaptive_constraints_confidence = other._adaptive_constraints_confidence;
+  _lexical_object_pruning = other._lexical_object_pruning;
+  _lexical_object_filter = other._lexical_object_filter;
+  _min_beam_width = other._min_beam_width;
+  _beam_mass = other._beam_mass;
   _solutions = other._solutions;
   _root = other._root;
+  _truncated = other._truncated;
+  _parse_index = other._parse_index;
+  _num_abandoned_parses = other._num_abandoned_parses;
+  _subtree_memo = other._subtree_memo;
+  _num_reused_subtrees = other._num_reused_subtrees;
+  _solution_cache = Solution_Cache( other._solution_cache.size() );
+  _incremental = other._incremental;
+  _num_scored = other._num_scored;
+  _canonical_constraints = other._canonical_constraints;
   return (*this);
 }
 
+/**
+ * search spaces are cached by the content hash of the world, most recently used first
+ */
 void
 DCG::
 fill_search_spaces( const World* world ){
-  for( unsigned int i = 0; i < _search_spaces.size(); i++ ){
-    if( _search_spaces[ i ].second != NULL ){
-      delete _search_spaces[ i ].second;
-      _search_spaces[ i ].second = NULL;
+  size_t world_hash = world->hash();
+  for( list< Search_Space* >::iterator it = _search_space_cache.begin(); it != _search_space_cache.end(); it++ ){
+    if( ( *it )->world_hash() == world_hash ){
+      _search_space = *it;
+      _search_space_cache.splice( _search_space_cache.begin(), _search_space_cache, it );
+      return;
     }
-    _search_spaces.clear();
   }
 
-  for( unsigned int i = 0; i < _correspondence_variables.size(); i++ ){
-    _correspondence_variables[ i ].clear();
-  }
-  _correspondence_variables.clear();
-
-
-  std::vector< unsigned int > binary_cvs;
-  binary_cvs.push_back( CV_FALSE );
-  binary_cvs.push_back( CV_TRUE );
-
-  std::vector< unsigned int > ternary_cvs;
-  ternary_cvs.push_back( CV_FALSE );
-  ternary_cvs.push_back( CV_TRUE );
-  ternary_cvs.push_back( CV_INVERTED );
-
-  _correspondence_variables.push_back( binary_cvs );
-  _correspondence_variables.push_back( ternary_cvs );
-
-  vector< std::string > regions;
-  regions.push_back( "na" );
-  regions.push_back( "near" );
-  regions.push_back( "far" );
-  regions.push_back( "left" );
-  regions.push_back( "right" );
-  regions.push_back( "front" );
-  regions.push_back( "back" );
-  regions.push_back( "above" );
-  regions.push_back( "below" );
-
-  vector< std::string > constraints;
-  constraints.push_back( "inside" );
-  constraints.push_back( "outside" );
-
-  // add the NP groundings; exhaustively fill the object symbol space (regions with unknown type and known object)
-  for( unsigned int i = 0; i < world->objects().size(); i++ ){
-    _search_spaces.push_back( pair< unsigned int, Grounding* >( 0, new Region( "na", *world->objects()[ i ] ) ) );
-  }
+  _search_space = new Search_Space();
+  _search_space->fill( world );
+  _search_space_cache.push_front( _search_space );
 
-  // add the PP groundings; exhaustively fill the region symbol space (does no duplicate the above loop)
-  for( unsigned int i = 0; i < regions.size(); i++ ){
-    if( regions[ i ] != "na" ){
-      _search_spaces.push_back( pair< unsigned int, Grounding* >( 0, new Region( regions[ i ], Object() ) ) );
-      for( unsigned int j = 0; j < world->objects().size(); j++ ){
-        _search_spaces.push_back( pair< unsigned int, Grounding* >( 0, new Region( regions[ i ], *world->objects()[ j ] ) ) );
-      }   
-    }
+  while( ( _search_space_cache.size() > 1 ) && ( _search_space_cache.size() > _search_space_cache_size ) ){
+    _solution_cache.erase_world( _search_space_cache.back()->world_hash() );
+    delete _search_space_cache.back();
+    _search_space_cache.pop_back();
   }
+  return;
+}
 
-  // add the VP groundings; exhaustively fill the constraint symbol space
-  for( unsigned int i = 0; i < constraints.size(); i++ ){
-    for( unsigned int j = 0; j < world->objects().size(); j++ ){
-      for( unsigned int k = 0; k < regions.size(); k++ ){
-        for( unsigned int l = 0; l < world->objects().size(); l++ ){
-          for( unsigned int m = 0; m < regions.size(); m++ ){
-            if( ( j != l ) || ( k != m ) ){
-              _search_spaces.push_back( pair< unsigned int, Grounding* >( 1, new Constraint( constraints[ i ], Region( regions[ k ], *world->objects()[ j ] ), Region( regions[ m ], *world->objects()[ l ] ) ) ) );
-            }
-          }
-        }
-      }
+void
+DCG::
+clear_search_spaces( void ){
+  for( list< Search_Space* >::iterator it = _search_space_cache.begin(); it != _search_space_cache.end(); it++ ){
+    if( *it != NULL ){
+      delete *it;
+      *it = NULL;
     }
   }
-
+  _search_space_cache.clear();
+  _search_space = NULL;
+  _solution_cache.clear();
   return;
 }
 
@@ -157,8 +187,9 @@ leaf_search( const Phrase* phrase,
               const World* world,
               LLM * llm,
               const unsigned int beamWidth,
-              const bool& debug ){
-  return leaf_search( phrase, world, NULL, llm, beamWidth, debug );
+              const bool& debug,
+              const Search_Budget* budget ){
+  return leaf_search( phrase, world, NULL, llm, beamWidth, debug, budget );
 }
   
 bool
@@ -168,14 +199,14 @@ leaf_search( const Phrase* phrase,
               const Grounding* context,
               LLM * llm,
               const unsigned int beamWidth,
-              const bool& debug ){
-  for( unsigned int i = 0; i < _solutions.size(); i++ ){
-    if( _solutions[ i ].second != NULL ){
-      delete _solutions[ i ].second;
-      _solutions[ i ].second = NULL;
-    }
-  }
-  _solutions.clear();
+              const bool& debug,
+              const Search_Budget* budget ){
+  _truncated = false;
+  _parse_index = 0;
+  _num_abandoned_parses = 0;
+  _subtree_memo.clear();
+  _num_reused_subtrees = 0;
+  _clear_solutions();
 
   if( phrase != NULL ){
     fill_search_spaces( world );
@@ -188,37 +219,97 @@ leaf_search( const Phrase* phrase,
     _root = new Factor_Set( phrase->dup() );
     _fill_factors( _root, _root->phrase() );  
 
-    Factor_Set * leaf = NULL;
-    _find_leaf( _root, leaf );
-    while( leaf != NULL ){
-      leaf->search( _search_spaces,
-                    _correspondence_variables,
-                    world,
-                    context,
-                    llm,
-                    beamWidth,
-                    debug );
-      leaf = NULL;
-      _find_leaf( _root, leaf );
+    _search_factors( _root, world, context, llm, beamWidth, debug, budget );
+    _fill_solutions();
+    return true;
+  } else {
+    return false;
+  }
+}
+
+bool
+DCG::
+leaf_search( const vector< Phrase* >& phrases,
+              const World* world,
+              LLM * llm,
+              const unsigned int beamWidth,
+              const bool& debug,
+              const Search_Budget* budget ){
+  return leaf_search( phrases, world, NULL, llm, beamWidth, debug, budget );
+}
+
+/**
+ * the parses compete for the best root solution; the score of the best finished parse 
+ *   bounds the search of the ones that follow, which are abandoned as soon as they cannot 
+ *   beat it; a truncated parse never replaces a complete one, since the factors it did 
+ *   not score count as one, and no parse is started once the budget has expired
+ */
+bool
+DCG::
+leaf_search( const vector< Phrase* >& phrases,
+              const World* world,
+              const Grounding* context,
+              LLM * llm,
+              const unsigned int beamWidth,
+              const bool& debug,
+              const Search_Budget* budget ){
+  _truncated = false;
+  _parse_index = 0;
+  _num_abandoned_parses = 0;
+  _subtree_memo.clear();
+  _num_reused_subtrees = 0;
+  _clear_solutions();
+  if( _root != NULL ){
+    delete _root;
+    _root = NULL;
+  }
+
+  fill_search_spaces( world );
+
+  double incumbent = 0.0;
+  bool root_truncated = false;
+  bool truncated = false;
+  for( unsigned int i = 0; i < phrases.size(); i++ ){
+    if( phrases[ i ] == NULL ){
+      continue;
+    }
+    if( ( _root != NULL ) && ( budget != NULL ) && ( budget->expired() ) ){
+      if( debug ){
+        cout << "  abandoned parses " << i << " to " << phrases.size() - 1 << " after the budget expired" << endl;
+      }
+      _num_abandoned_parses += phrases.size() - i;
+      truncated = true;
+      break;
     }
-  
-    for( unsigned int i = 0; i < _root->solutions().size(); i++ ){
-      _solutions.push_back( pair< double, Phrase* >( _root->solutions()[ i ].pygx, _root->phrase()->dup() ) );
 
-      for( unsigned int j = 0; j < _solutions.back().second->children().size(); j++ ){
-        if( _solutions.back().second->children()[ j ] != NULL ){
-          delete _solutions.back().second->children()[ j ];
-          _solutions.back().second->children()[ j ];
-        }
+    Factor_Set * root = new Factor_Set( phrases[ i ]->dup() );
+    _fill_factors( root, root->phrase() );
+
+    // only a complete incumbent bounds the search of the parses that follow
+    _truncated = false;
+    bool searched = _search_factors( root, world, context, llm, beamWidth, debug, budget, root_truncated ? 0.0 : incumbent );
+    bool parse_truncated = _truncated;
+    truncated = truncated || parse_truncated;
+    if( searched && !root->solutions().empty() && ( ( _root == NULL ) || ( root_truncated && !parse_truncated ) || ( ( root_truncated == parse_truncated ) && ( root->solutions().front().pygx > incumbent ) ) ) ){
+      if( _root != NULL ){
+        delete _root;
       }
-      _solutions.back().second->children().clear();
-      if( _solutions.back().second->grounding() != NULL ){
-        delete _solutions.back().second->grounding();
-        _solutions.back().second->grounding() = NULL;
+      _root = root;
+      _parse_index = i;
+      incumbent = _root->solutions().front().pygx;
+      root_truncated = parse_truncated;
+    } else {
+      if( debug ){
+        cout << "  abandoned parse " << i << " below the incumbent " << incumbent << endl;
       }
-      _fill_phrase( _root, _root->solutions()[ i ], _solutions.back().second );
+      _num_abandoned_parses++;
+      delete root;
     }
+  }
+  _truncated = truncated;
 
+  if( _root != NULL ){
+    _fill_solutions();
     return true;
   } else {
     return false;
@@ -236,6 +327,367 @@ to_latex( const string& filename )const{
   return;
 } 
 
+bool
+DCG::
+update( const World* world,
+        const World_Diff& diff,
+        LLM * llm,
+        const unsigned int beamWidth,
+        const bool& debug,
+        const Search_Budget* budget ){
+  return update( world, diff, NULL, llm, beamWidth, debug, budget );
+}
+
+/**
+ * grounds the last searched phrase in a world that differs from the searched one by diff; 
+ *   the groundings of changed objects are updated in place and, with incremental() set, 
+ *   each factor only scores the groundings that changed since the last search
+ */
+bool
+DCG::
+update( const World* world,
+        const World_Diff& diff,
+        const Grounding* context,
+        LLM * llm,
+        const unsigned int beamWidth,
+        const bool& debug,
+        const Search_Budget* budget ){
+  if( ( _root == NULL ) || ( _search_space == NULL ) ){
+    return false;
+  }
+
+  _truncated = false;
+  _subtree_memo.clear();
+  _num_reused_subtrees = 0;
+  _clear_solutions();
+  _clear_factor_solutions( _root );
+
+  // cached solutions point into the search space that is about to change
+  _solution_cache.erase_world( _search_space->world_hash() );
+  if( !_search_space->update( world, diff ) && debug ){
+    cout << "  filled the search space again for " << diff << endl;
+  }
+
+  bool complete = _search_factors( _root, world, context, llm, beamWidth, debug, budget );
+  if( debug ){
+    cout << "  scored " << _num_scored << " groundings for " << diff << endl;
+  }
+  if( complete ){
+    _fill_solutions();
+  }
+  return complete;
+}
+
+/**
+ * searches the factors of the tree bottom-up, returning false if the root can no 
+ *   longer reach the incumbent score
+ */
+bool
+DCG::
+_search_factors( Factor_Set* root,
+                  const World* world,
+                  const Grounding* context,
+                  LLM* llm,
+                  const unsigned int beamWidth,
+                  const bool& debug,
+                  const Search_Budget* budget,
+                  const double& incumbent ){
+  // solutions outlive the query only without a context, which has no content hash
+  bool cacheable = ( context == NULL ) && ( _solution_cache.size() > 0 );
+  _num_scored = 0;
+  size_t query_key = cacheable ? _query_key( llm ) : 0;
+
+  // the grounding-only features are evaluated once per world and feature set
+  if( _search_space->feature_table().feature_set() != llm->feature_set() ){
+    _search_space->feature_table().fill( llm->feature_set(), _search_space->groundings(), world );
+  }
+
+  vector< pair< unsigned int, Grounding* > > search_space;
+  Factor_Set * leaf = NULL;
+  _find_leaf( root, leaf );
+  while( leaf != NULL ){
+    // as the budget drains the beam shrinks, then the search space is reduced, then
+    //   the remaining factors only complete the solution with false correspondences
+    unsigned int beam_width = beamWidth;
+    bool reduce_coverage = false;
+    bool expired = false;
+    if( budget != NULL ){
+      double remaining_fraction = budget->remaining_fraction();
+      if( budget->expired() ){
+        beam_width = 1;
+        expired = true;
+      } else if( remaining_fraction < 1.0 ){
+        beam_width = ( unsigned int )( ceil( ( double )( beamWidth ) * remaining_fraction ) );
+        if( beam_width < 1 ){
+          beam_width = 1;
+        }
+        reduce_coverage = ( remaining_fraction < 0.5 );
+      }
+      if( expired || ( beam_width < beamWidth ) || ( reduce_coverage ) ){
+        _truncated = true;
+      }
+    }
+
+    // the rest of the tree can at best contribute its finished subtrees' top scores
+    double threshold = 0.0;
+    if( incumbent > 0.0 ){
+      double upper_bound = _upper_bound( root, leaf );
+      if( upper_bound < incumbent ){
+        return false;
+      }
+      threshold = incumbent / upper_bound;
+    }
+
+    // identical subtrees within and across the parses of a query are only searched once; 
+    //   solutions found with a lower threshold are a superset of the ones needed here
+    //   and the ones searched by earlier queries are looked up in the solution cache;
+    //   the hashes only select the candidates, a hit must have the same structure
+    size_t subtree_key = _subtree_key( leaf, world, context );
+    string subtree;
+    _subtree_structure( leaf, subtree );
+    size_t cache_key = leaf->phrase()->hash();
+    boost::hash_combine( cache_key, query_key );
+    const Factor_Set_Subtree_Solutions* subtree_solutions = NULL;
+    map< size_t, Factor_Set_Subtree_Solutions >::const_iterator it_subtree_memo = _subtree_memo.find( subtree_key );
+    if( ( it_subtree_memo != _subtree_memo.end() ) && ( it_subtree_memo->second.subtree == subtree ) && ( it_subtree_memo->second.beam_width == beam_width ) && ( it_subtree_memo->second.threshold <= threshold ) ){
+      subtree_solutions = &( it_subtree_memo->second );
+    } else if( cacheable ){
+      subtree_solutions = _solution_cache.find( cache_key, query_key, subtree, beam_width, threshold );
+    }
+
+    if( subtree_solutions != NULL ){
+      unsigned int index = 0;
+      _restore_subtree( leaf, subtree_solutions->solutions, index );
+      _num_reused_subtrees++;
+      if( debug ){
+        cout << "  reused the solutions of \"" << leaf->phrase()->words_to_std_string() << "\"" << endl;
+      }
+    } else {
+      if( ( budget != NULL ) && ( budget->expired() ) ){
+        expired = true;
+        _truncated = true;
+        search_space.clear();
+      } else {
+        _filter_search_space( leaf, llm, search_space, reduce_coverage );
+      }
+      // beam_mass() below one lets each factor keep fewer solutions than the beam width 
+      leaf->min_beam_width() = _min_beam_width;
+      leaf->beam_mass() = _beam_mass;
+      leaf->cache_scores() = _incremental;
+      // each canonical constraint is searched together with its mirror
+      vector< Grounding* > mirrors;
+      if( _canonical_constraints ){
+        mirrors.resize( search_space.size() );
+        for( unsigned int i = 0; i < search_space.size(); i++ ){
+          mirrors[ i ] = _search_space->mirror( search_space[ i ].second );
+        }
+      }
+      leaf->search( search_space,
+                    _search_space->correspondence_variables(),
+                    world,
+                    context,
+                    llm,
+                    beam_width,
+                    debug,
+                    budget,
+                    threshold,
+                    &_search_space->feature_table(),
+                    _canonical_constraints ? &mirrors : NULL );
+      _num_scored += leaf->num_scored();
+      if( _canonical_constraints ){
+        _add_mirrored_groundings( leaf, search_space );
+      }
+      // solutions completed with false correspondences after the budget expired are 
+      //   not results, so neither the memo nor the solution cache keeps them; the cache 
+      //   outlives the query, so it only keeps solutions of a search that was never cut short
+      if( leaf->truncated() || expired ){
+        _truncated = true;
+      } else if( !leaf->solutions().empty() ){
+        Factor_Set_Subtree_Solutions& memo_solutions = _subtree_memo[ subtree_key ];
+        memo_solutions = Factor_Set_Subtree_Solutions( subtree, beam_width, threshold );
+        _store_subtree( leaf, memo_solutions.solutions );
+        if( cacheable && !reduce_coverage && ( beam_width == beamWidth ) && !_truncated ){
+          _solution_cache.insert( cache_key, query_key, _search_space->world_hash(), memo_solutions );
+        }
+      }
+      if( debug && _truncated ){
+        cout << "  search truncated for \"" << leaf->phrase()->words_to_std_string() << "\" with beam width " << beam_width << endl;
+      }
+    }
+    if( leaf->solutions().empty() ){
+      return false;
+    }
+    leaf = NULL;
+    _find_leaf( root, leaf );
+  }
+  return true;
+}
+
+/**
+ * the product of the best scores of the finished subtrees, excluding the one being searched
+ */
+double
+DCG::
+_upper_bound( const Factor_Set* node,
+              const Factor_Set* leaf )const{
+  if( node == leaf ){
+    return 1.0;
+  } else if( !node->solutions().empty() ){
+    return node->solutions().front().pygx;
+  } else {
+    double upper_bound = 1.0;
+    for( unsigned int i = 0; i < node->children().size(); i++ ){
+      upper_bound *= _upper_bound( node->children()[ i ], leaf );
+    }
+    return upper_bound;
+  }
+}
+
+size_t
+DCG::
+_subtree_key( const Factor_Set* node,
+              const World* world,
+              const Grounding* context )const{
+  size_t seed = node->phrase()->hash();
+  boost::hash_combine( seed, world );
+  boost::hash_combine( seed, context );
+  return seed;
+}
+
+/**
+ * serializes the phrase types, words and shape of a subtree, which identify it exactly
+ */
+void
+DCG::
+_subtree_structure( const Factor_Set* node,
+                    string& structure )const{
+  stringstream structure_stream;
+  structure_stream << "(" << node->phrase()->type();
+  for( unsigned int i = 0; i < node->phrase()->words().size(); i++ ){
+    const Word& word = node->phrase()->words()[ i ];
+    structure_stream << " " << word.pos() << ":" << word.text().size() << ":" << word.text();
+  }
+  structure += structure_stream.str();
+  for( unsigned int i = 0; i < node->children().size(); i++ ){
+    structure += " ";
+    _subtree_structure( node->children()[ i ], structure );
+  }
+  structure += ")";
+  return;
+}
+
+/**
+ * identifies the world, model and search settings that the cached solutions depend on
+ */
+size_t
+DCG::
+_query_key( const LLM* llm )const{
+  size_t seed = _search_space->world_hash();
+  boost::hash_combine( seed, llm->hash() );
+  boost::hash_combine( seed, _adaptive_constraints );
+  boost::hash_combine( seed, _adaptive_constraints_confidence );
+  boost::hash_combine( seed, _lexical_object_pruning );
+  boost::hash_combine( seed, _lexical_object_filter.threshold() );
+  boost::hash_combine( seed, _min_beam_width );
+  boost::hash_combine( seed, _beam_mass );
+  boost::hash_combine( seed, _canonical_constraints );
+  for( map< phrase_type_t, vector< string > >::const_iterator it = _search_space_filter.grounding_classes().begin(); it != _search_space_filter.grounding_classes().end(); it++ ){
+    boost::hash_combine( seed, it->first );
+    boost::hash_range( seed, it->second.begin(), it->second.end() );
+  }
+  return seed;
+}
+
+void
+DCG::
+_store_subtree( const Factor_Set* node,
+                vector< vector< Factor_Set_Solution > >& solutions )const{
+  solutions.push_back( node->solutions() );
+  for( unsigned int i = 0; i < node->children().size(); i++ ){
+    _store_subtree( node->children()[ i ], solutions );
+  }
+  return;
+}
+
+void
+DCG::
+_restore_subtree( Factor_Set* node,
+                  const vector< vector< Factor_Set_Solution > >& solutions,
+                  unsigned int& index )const{
+  node->solutions() = solutions[ index ];
+  index++;
+  for( unsigned int i = 0; i < node->children().size(); i++ ){
+    _restore_subtree( node->children()[ i ], solutions, index );
+  }
+  return;
+}
+
+/**
+ * adds the mirror of each canonical constraint assigned CV_INVERTED to the solution groundings
+ */
+void
+DCG::
+_add_mirrored_groundings( Factor_Set* node,
+                          const vector< pair< unsigned int, Grounding* > >& searchSpace )const{
+  for( unsigned int i = 0; i < node->solutions().size(); i++ ){
+    Factor_Set_Solution& solution = node->solutions()[ i ];
+    if( solution.cv.size() > CV_INVERTED ){
+      for( unsigned int j = 0; j < solution.cv[ CV_INVERTED ].size(); j++ ){
+        Grounding * mirror = _search_space->mirror( searchSpace[ solution.cv[ CV_INVERTED ][ j ] ].second );
+        if( mirror != NULL ){
+          solution.groundings.push_back( mirror );
+        }
+      }
+    }
+  }
+  return;
+}
+
+void
+DCG::
+_clear_factor_solutions( Factor_Set* node ){
+  node->solutions().clear();
+  for( unsigned int i = 0; i < node->children().size(); i++ ){
+    _clear_factor_solutions( node->children()[ i ] );
+  }
+  return;
+}
+
+void
+DCG::
+_clear_solutions( void ){
+  for( unsigned int i = 0; i < _solutions.size(); i++ ){
+    if( _solutions[ i ].second != NULL ){
+      delete _solutions[ i ].second;
+      _solutions[ i ].second = NULL;
+    }
+  }
+  _solutions.clear();
+  return;
+}
+
+void
+DCG::
+_fill_solutions( void ){
+  for( unsigned int i = 0; i < _root->solutions().size(); i++ ){
+    _solutions.push_back( pair< double, Phrase* >( _root->solutions()[ i ].pygx, _root->phrase()->dup() ) );
+
+    for( unsigned int j = 0; j < _solutions.back().second->children().size(); j++ ){
+      if( _solutions.back().second->children()[ j ] != NULL ){
+        delete _solutions.back().second->children()[ j ];
+        _solutions.back().second->children()[ j ];
+      }
+    }
+    _solutions.back().second->children().clear();
+    if( _solutions.back().second->grounding() != NULL ){
+      delete _solutions.back().second->grounding();
+      _solutions.back().second->grounding() = NULL;
+    }
+    _fill_phrase( _root, _root->solutions()[ i ], _solutions.back().second );
+  }
+  return;
+}
+
 void
 DCG::
 _find_leaf( Factor_Set* node, 
@@ -301,6 +753,131 @@ _fill_factors( Factor_Set* node,
   return;
 }
 
+/**
+ * copies the partitions of the search space whose grounding class is allowed for the phrase type;
+ *   with lexical object pruning the regions over objects outside the bound of the phrase are skipped;
+ *   reduceCoverage forces lexical object pruning and adaptive constraints on
+ */
+void
+DCG::
+_filter_search_space( const Factor_Set* node,
+                      const LLM* llm,
+                      vector< pair< unsigned int, Grounding* > >& searchSpace,
+                      const bool& reduceCoverage )const{
+  searchSpace.clear();
+
+  vector< string > object_types;
+  bool prune_objects = false;
+  if( _lexical_object_pruning || reduceCoverage ){
+    prune_objects = _lexical_object_filter.object_types( node->phrase(), llm, object_types );
+  }
+
+  for( unsigned int i = 0; i < _search_space->partitions().size(); i++ ){
+    if( _search_space_filter.allows( node->phrase()->type(), _search_space->partitions()[ i ].first ) ){
+      if( ( _adaptive_constraints || reduceCoverage ) && ( _search_space->partitions()[ i ].first == Constraint::class_name() ) ){
+        if( _fill_adaptive_constraints( node, searchSpace ) ){
+          continue;
+        }
+      }
+      if( prune_objects && ( _search_space->partitions()[ i ].first == Region::class_name() ) ){
+        for( unsigned int j = _search_space->partitions()[ i ].second.first; j < _search_space->partitions()[ i ].second.second; j++ ){
+          const Region * region = static_cast< const Region* >( _search_space->groundings()[ j ].second );
+          if( ( region->object().object_type() == "na" ) || ( find( object_types.begin(), object_types.end(), region->object().object_type() ) != object_types.end() ) ){
+            searchSpace.push_back( _search_space->groundings()[ j ] );
+          }
+        }
+        continue;
+      }
+      // the mirror of a canonical constraint is expressed by its inverted correspondence variable
+      if( _canonical_constraints && ( _search_space->partitions()[ i ].first == Constraint::class_name() ) ){
+        for( unsigned int j = _search_space->partitions()[ i ].second.first; j < _search_space->partitions()[ i ].second.second; j++ ){
+          if( _search_space->is_canonical( j ) ){
+            searchSpace.push_back( _search_space->groundings()[ j ] );
+          }
+        }
+        continue;
+      }
+      searchSpace.insert( searchSpace.end(), 
+                          _search_space->groundings().begin() + _search_space->partitions()[ i ].second.first, 
+                          _search_space->groundings().begin() + _search_space->partitions()[ i ].second.second );
+    }
+  }
+  return;
+}
+
+/**
+ * adds the constraints between the regions in the children's solutions and
+ *   between those regions and the unknown region type of every object; 
+ *   returns false when any child is not confident in its best solution 
+ */
+bool
+DCG::
+_fill_adaptive_constraints( const Factor_Set* node,
+                            vector< pair< unsigned int, Grounding* > >& searchSpace )const{
+  if( node->children().empty() ){
+    return false;
+  }
+
+  vector< pair< unsigned int, unsigned int > > child_regions;
+  for( unsigned int i = 0; i < node->children().size(); i++ ){
+    const vector< Factor_Set_Solution >& solutions = node->children()[ i ]->solutions();
+    if( solutions.empty() ){
+      return false;
+    }
+    double pygx_sum = 0.0;
+    for( unsigned int j = 0; j < solutions.size(); j++ ){
+      pygx_sum += solutions[ j ].pygx;
+    }
+    if( ( pygx_sum <= 0.0 ) || ( ( solutions.front().pygx / pygx_sum ) < _adaptive_constraints_confidence ) ){
+      return false;
+    }
+    for( unsigned int j = 0; j < solutions.size(); j++ ){
+      for( unsigned int k = 0; k < solutions[ j ].groundings.size(); k++ ){
+        pair< unsigned int, unsigned int > region;
+        if( _search_space->region_indices( solutions[ j ].groundings[ k ], region.first, region.second ) ){
+          if( find( child_regions.begin(), child_regions.end(), region ) == child_regions.end() ){
+            child_regions.push_back( region );
+          }
+        }
+      }
+    }
+  }
+
+  if( child_regions.empty() ){
+    return false;
+  }
+
+  vector< pair< unsigned int, unsigned int > > regions = child_regions;
+  for( unsigned int i = 0; i < _search_space->num_objects(); i++ ){
+    pair< unsigned int, unsigned int > region( i, 0 );
+    if( find( regions.begin(), regions.end(), region ) == regions.end() ){
+      regions.push_back( region );
+    }
+  }
+
+  vector< unsigned int > indices;
+  for( unsigned int i = 0; i < _search_space->constraint_types().size(); i++ ){
+    for( unsigned int j = 0; j < child_regions.size(); j++ ){
+      for( unsigned int k = 0; k < regions.size(); k++ ){
+        if( child_regions[ j ] != regions[ k ] ){
+          indices.push_back( _search_space->constraint_index( i, regions[ k ].first, regions[ k ].second, child_regions[ j ].first, child_regions[ j ].second ) );
+          indices.push_back( _search_space->constraint_index( i, child_regions[ j ].first, child_regions[ j ].second, regions[ k ].first, regions[ k ].second ) );
+        }
+      }
+    }
+  }
+
+  // keep the order of the exhaustive search space
+  sort( indices.begin(), indices.end() );
+  indices.erase( unique( indices.begin(), indices.end() ), indices.end() );
+  for( unsigned int i = 0; i < indices.size(); i++ ){
+    if( !_canonical_constraints || _search_space->is_canonical( indices[ i ] ) ){
+      searchSpace.push_back( _search_space->groundings()[ indices[ i ] ] );
+    }
+  }
+  return true;
+}
+
 namespace h2sl {
   ostream&
   operator<<( ostream& out,
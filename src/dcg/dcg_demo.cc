@@ -38,6 +38,7 @@
 #include "h2sl/phrase.h"
 #include "h2sl/constraint.h"
 #include "h2sl/parser_cyk.h"
+#include "h2sl/world_diff.h"
 #include "h2sl/dcg.h"
 #include "dcg_demo_cmdline.h"
 
@@ -75,7 +76,18 @@ main( int argc,
   }
 
   DCG * dcg = new DCG();
-  
+  if( args.search_space_filter_given ){
+    dcg->search_space_filter().from_xml( args.search_space_filter_arg );
+  }
+  dcg->adaptive_constraints() = ( args.adaptive_constraints_arg != 0 );
+  dcg->adaptive_constraints_confidence() = args.adaptive_constraints_confidence_arg;
+  dcg->lexical_object_pruning() = ( args.lexical_object_pruning_arg != 0 );
+  dcg->lexical_object_filter().threshold() = args.lexical_object_threshold_arg;
+  dcg->min_beam_width() = args.min_beam_width_arg;
+  dcg->beam_mass() = args.beam_mass_arg;
+  dcg->canonical_constraints() = ( args.canonical_constraints_arg != 0 );
+  dcg->incremental() = args.update_world_given;
+
   struct timeval start_time;
   gettimeofday( &start_time, NULL );
 
@@ -96,11 +108,15 @@ main( int argc,
     
         gettimeofday( &start_time, NULL );
 
-        dcg->leaf_search( phrases[ i ], world, context, llm, args.beam_width_arg );
+        Search_Budget budget( args.deadline_arg );
+        dcg->leaf_search( phrases[ i ], world, context, llm, args.beam_width_arg, false, &budget );
 
         gettimeofday( &end_time, NULL );
 
         cout << "finished search in " << diff_time( start_time, end_time ) << " seconds" << endl;   
+        if( dcg->truncated() ){
+          cout << "search was truncated by the " << args.deadline_arg << " second deadline" << endl;
+        }
         for( unsigned int j = 0; j < dcg->solutions().size(); j++ ){
           cout << "  solutions[" << j << "]:" << *dcg->solutions()[ j ].second << " (" << dcg->solutions()[ j ].first << ")" << endl;
         }
@@ -132,6 +148,28 @@ main( int argc,
             }
           }
         } 
+
+        // ground the command again in the updated world, scoring only what changed
+        if( args.update_world_given ){
+          World * update_world = new World();
+          update_world->from_xml( args.update_world_arg );
+          World_Diff world_diff( world, update_world );
+          cout << "world diff " << world_diff << endl;
+
+          gettimeofday( &start_time, NULL );
+          dcg->update( update_world, world_diff, context, llm, args.beam_width_arg );
+          gettimeofday( &end_time, NULL );
+
+          cout << "finished update in " << diff_time( start_time, end_time ) << " seconds (scored " << dcg->num_scored() << " groundings)" << endl;
+          for( unsigned int j = 0; j < dcg->solutions().size(); j++ ){
+            cout << "  solutions[" << j << "]:" << *dcg->solutions()[ j ].second << " (" << dcg->solutions()[ j ].first << ")" << endl;
+          }
+
+          // the next phrase is searched in the original world
+          dcg->fill_search_spaces( world );
+          delete update_world;
+          update_world = NULL;
+        }
       }
     }
   }
@@ -35,9 +35,11 @@
 #include <sys/time.h>
 #include "h2sl/common.h"
 #include "h2sl/phrase.h"
+#include "h2sl/region.h"
 #include "h2sl/constraint.h"
 #include "h2sl/grounding_set.h"
 #include "h2sl/parser_cyk.h"
+#include "h2sl/search_budget.h"
 #include "h2sl/dcg.h"
 #include "dcg_test_cmdline.h"
 
@@ -108,6 +110,35 @@ compare_phrases( const Phrase* first,
   return true;
 }
 
+/**
+ * counts the regions over known objects in a solution and the ones kept by the lexical object filter
+ */
+void
+lexical_object_filter_recall( const Phrase* phrase,
+                              const Lexical_Object_Filter& lexicalObjectFilter,
+                              const LLM* llm,
+                              unsigned int& numKept,
+                              unsigned int& numTotal ){
+  vector< string > object_types;
+  bool prune_objects = lexicalObjectFilter.object_types( phrase, llm, object_types );
+  const Grounding_Set * grounding_set = dynamic_cast< const Grounding_Set* >( phrase->grounding() );
+  if( grounding_set != NULL ){
+    for( unsigned int i = 0; i < grounding_set->groundings().size(); i++ ){
+      const Region * region = dynamic_cast< const Region* >( grounding_set->groundings()[ i ] );
+      if( ( region != NULL ) && ( region->object().object_type() != "na" ) ){
+        numTotal++;
+        if( !prune_objects || ( find( object_types.begin(), object_types.end(), region->object().object_type() ) != object_types.end() ) ){
+          numKept++;
+        }
+      }
+    }
+  }
+  for( unsigned int i = 0; i < phrase->children().size(); i++ ){
+    lexical_object_filter_recall( phrase->children()[ i ], lexicalObjectFilter, llm, numKept, numTotal );
+  }
+  return;
+}
+
 int
 main( int argc,
       char* argv[] ) {
@@ -119,7 +150,7 @@ main( int argc,
     exit(1);
   }
 
-  Parser< Phrase > * parser = new Parser_CYK< Phrase >();
+  Parser< Phrase > * parser = new Parser_CYK< Phrase >( args.max_parses_arg, ( args.probabilistic_parser_arg != 0 ), args.parser_beam_width_arg );
   Grammar * grammar = new Grammar();
   grammar->from_xml( args.grammar_arg );
 
@@ -130,9 +161,25 @@ main( int argc,
   }
 
   DCG * dcg = new DCG();
+  if( args.search_space_filter_given ){
+    dcg->search_space_filter().from_xml( args.search_space_filter_arg );
+  }
+  dcg->adaptive_constraints() = ( args.adaptive_constraints_arg != 0 );
+  dcg->adaptive_constraints_confidence() = args.adaptive_constraints_confidence_arg;
+  dcg->lexical_object_pruning() = ( args.lexical_object_pruning_arg != 0 );
+  dcg->lexical_object_filter().threshold() = args.lexical_object_threshold_arg;
+  dcg->min_beam_width() = args.min_beam_width_arg;
+  dcg->beam_mass() = args.beam_mass_arg;
+  dcg->canonical_constraints() = ( args.canonical_constraints_arg != 0 );
+  dcg->solution_cache().size() = args.solution_cache_size_arg;
 
   unsigned int num_correct = 0;
   unsigned int num_incorrect = 0;
+  unsigned int num_best_parse_correct = 0;
+  unsigned int num_kept_regions = 0;
+  unsigned int num_total_regions = 0;
+  unsigned int num_unchanged_after_cancel = 0;
+  unsigned int num_cancel_checks = 0;
 
   for( unsigned int i = 0; i < args.inputs_num; i++ ){
     cout << "reading file " << args.inputs[ i ] << endl;
@@ -152,6 +199,19 @@ main( int argc,
       if( !phrases.empty() ){
         cout << "found " << phrases.size() << " phrases" << endl;
         cout << "  truth:" << *truth << endl;
+        // compare the lexical object bounds against the solution of the full search
+        if( dcg->lexical_object_pruning() ){
+          dcg->lexical_object_pruning() = false;
+          for( unsigned int i = 0; i < phrases.size(); i++ ){
+            if( phrases[ i ] != NULL ){
+              dcg->leaf_search( phrases[ i ], world, context, llm, args.beam_width_arg );
+              if( !dcg->solutions().empty() ){
+                lexical_object_filter_recall( dcg->solutions().front().second, dcg->lexical_object_filter(), llm, num_kept_regions, num_total_regions );
+              }
+            }
+          }
+          dcg->lexical_object_pruning() = true;
+        }
         bool found_match = false;
         unsigned int match_index = 0;
         for( unsigned int i = 0; i < phrases.size(); i++ ){
@@ -166,6 +226,43 @@ main( int argc,
             }
           }
         }
+        // the search over all parses that keeps only the parse with the best root score is scored separately
+        dcg->leaf_search( phrases, world, context, llm, args.beam_width_arg );
+        if( !dcg->solutions().empty() ){
+          cout << "  best parse[" << dcg->parse_index() << "]:" << *dcg->solutions().front().second << " (" << dcg->solutions().front().first << ")" << endl; 
+          if( dcg->num_abandoned_parses() > 0 ){
+            cout << "  abandoned " << dcg->num_abandoned_parses() << " of " << phrases.size() << " parses" << endl;
+          }
+          if( dcg->num_reused_subtrees() > 0 ){
+            cout << "  reused the solutions of " << dcg->num_reused_subtrees() << " subtrees" << endl;
+          }
+          if( compare_phrases( truth, dcg->solutions().front().second ) ){
+            num_best_parse_correct++;
+          }
+        }
+        // a cancelled search must not leave anything in the solution cache that changes the search that follows it
+        if( ( dcg->solution_cache().size() > 0 ) && ( phrases[ match_index ] != NULL ) ){
+          unsigned int cache_size = dcg->solution_cache().size();
+          dcg->solution_cache().size() = 0;
+          dcg->leaf_search( phrases[ match_index ], world, context, llm, 1 );
+          dcg->solution_cache().size() = cache_size;
+          if( !dcg->solutions().empty() ){
+            double reference_pygx = dcg->solutions().front().first;
+            Phrase * reference = dcg->solutions().front().second->dup();
+            Search_Budget cancelled_budget;
+            cancelled_budget.cancel();
+            dcg->leaf_search( phrases[ match_index ], world, context, llm, args.beam_width_arg, false, &cancelled_budget );
+            bool cancelled_truncated = dcg->truncated();
+            dcg->leaf_search( phrases[ match_index ], world, context, llm, 1 );
+            if( cancelled_truncated && !dcg->solutions().empty() && ( dcg->solutions().front().first == reference_pygx ) && compare_phrases( reference, dcg->solutions().front().second ) ){
+              num_unchanged_after_cancel++;
+            } else {
+              cout << "  cancelled search changed the following search of parse[" << match_index << "]" << endl;
+            }
+            num_cancel_checks++;
+            delete reference;
+          }
+        }
         if( found_match ){
           cout << "  phrase[" << match_index << "] matches" << endl;
           num_correct++;
@@ -200,6 +297,16 @@ main( int argc,
   }
 
   cout << "correctly inferred " << num_correct << " of " << num_correct + num_incorrect << " examples (" << ( double )( num_correct ) / ( double )( num_correct + num_incorrect ) * 100.0 << "%)" << endl;
+  cout << "best parse search correctly inferred " << num_best_parse_correct << " of " << num_correct + num_incorrect << " examples (" << ( double )( num_best_parse_correct ) / ( double )( num_correct + num_incorrect ) * 100.0 << "%)" << endl;
+  if( dcg->lexical_object_pruning() && ( num_total_regions > 0 ) ){
+    cout << "lexical object filter kept " << num_kept_regions << " of " << num_total_regions << " regions of the full search (" << ( double )( num_kept_regions ) / ( double )( num_total_regions ) * 100.0 << "% recall)" << endl;
+  }
+  if( num_cancel_checks > 0 ){
+    cout << "cancelled searches left the following search unchanged for " << num_unchanged_after_cancel << " of " << num_cancel_checks << " examples" << endl;
+  }
+  if( dcg->solution_cache().size() > 0 ){
+    cout << "solution cache " << dcg->solution_cache() << endl;
+  }
 
   if( dcg != NULL ){
     delete dcg;
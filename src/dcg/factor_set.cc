@@ -31,7 +31,11 @@
  * The implementation of a class used to represent a factor set
  */
 
+#include <queue>
+#include <functional>
+#include <boost/functional/hash.hpp>
 #include "h2sl/common.h"
+#include "h2sl/region.h"
 #include "h2sl/constraint.h"
 #include "h2sl/factor_set.h"
 
@@ -44,6 +48,12 @@ factor_set_solution_sort( const Factor_Set_Solution& a,
   return a.pygx > b.pygx;
 }
 
+bool
+factor_set_candidate_sort( const pair< double, pair< unsigned int, unsigned int > >& a,
+                            const pair< double, pair< unsigned int, unsigned int > >& b ){
+  return a.first > b.first;
+}
+
 Factor_Set_Solution::
 Factor_Set_Solution() : cv(),
                             children(),
@@ -78,7 +88,13 @@ operator=( const Factor_Set_Solution& other ){
 Factor_Set::
 Factor_Set( const Phrase* phrase ) : _phrase( phrase ),
                                           _children(),
-                                          _solutions() {
+                                          _solutions(),
+                                          _truncated( false ),
+                                          _min_beam_width( 1 ),
+                                          _beam_mass( 1.0 ),
+                                          _cache_scores( false ),
+                                          _scores(),
+                                          _num_scored( 0 ) {
 
 }
 
@@ -90,7 +106,13 @@ Factor_Set::
 Factor_Set::
 Factor_Set( const Factor_Set& other ) : _phrase( other._phrase ),
                                                 _children( other._children ),
-                                                _solutions( other._solutions ){
+                                                _solutions( other._solutions ),
+                                                _truncated( other._truncated ),
+                                                _min_beam_width( other._min_beam_width ),
+                                                _beam_mass( other._beam_mass ),
+                                                _cache_scores( other._cache_scores ),
+                                                _scores( other._scores ),
+                                                _num_scored( other._num_scored ){
 
 }
 
@@ -100,6 +122,12 @@ operator=( const Factor_Set& other ) {
   _phrase = other._phrase;
   _children = other._children;
   _solutions = other._solutions;
+  _truncated = other._truncated;
+  _min_beam_width = other._min_beam_width;
+  _beam_mass = other._beam_mass;
+  _cache_scores = other._cache_scores;
+  _scores = other._scores;
+  _num_scored = other._num_scored;
   return (*this);
 }
 
@@ -110,8 +138,12 @@ search( const vector< pair< unsigned int, Grounding* > >& searchSpace,
         const World* world,
         LLM* llm,
         const unsigned int beamWidth,
-        const bool& debug ){
-  search( searchSpace, correspondenceVariables, world, NULL, llm, beamWidth, debug );
+        const bool& debug,
+        const Search_Budget* budget,
+        const double& threshold,
+        const Feature_Table* featureTable,
+        const vector< Grounding* >* mirrors ){
+  search( searchSpace, correspondenceVariables, world, NULL, llm, beamWidth, debug, budget, threshold, featureTable, mirrors );
   return;
 }
 
@@ -123,7 +155,12 @@ search( const vector< pair< unsigned int, Grounding* > >& searchSpace,
         const Grounding* context, 
         LLM* llm,
         const unsigned int beamWidth,
-        const bool& debug ){
+        const bool& debug,
+        const Search_Budget* budget,
+        const double& threshold,
+        const Feature_Table* featureTable,
+        const vector< Grounding* >* mirrors ){
+  _truncated = false;
 
   vector< vector< unsigned int > > child_solution_indices;
   for( unsigned int i = 0; i < _children.size(); i++ ){
@@ -140,76 +177,238 @@ search( const vector< pair< unsigned int, Grounding* > >& searchSpace,
 
   vector< bool > evaluate_feature_types( NUM_FEATURE_TYPES, true );
 
-  vector< vector< Factor_Set_Solution > > solutions_vector;
-  for( unsigned int i = 0; i < child_solution_indices_cartesian_power.size(); i++ ){
-    solutions_vector.push_back( vector< Factor_Set_Solution >() );
-    solutions_vector.back().push_back( Factor_Set_Solution() );
-    solutions_vector.back().back().children = child_solution_indices_cartesian_power[ i ];
-    solutions_vector.back().back().cv.resize( NUM_CVS );
+  // partial solutions are (pygx, node) pairs into a per-combination arena of delta chains
+  vector< vector< Factor_Set_Solution_Node > > nodes_vector( child_solution_indices_cartesian_power.size() );
+  vector< vector< pair< double, int > > > beams_vector( child_solution_indices_cartesian_power.size() );
+  vector< pair< double, pair< unsigned int, unsigned int > > > candidates;
+  vector< double > values;
+
+  // scores are cached by the content of the grounding and the child groundings, so 
+  //   only the entries that changed since the last search are evaluated again
+  _num_scored = 0;
+  vector< size_t > grounding_hashes;
+  map< size_t, vector< double > > scores;
+  if( _cache_scores ){
+    grounding_hashes.resize( searchSpace.size() );
+    for( unsigned int i = 0; i < searchSpace.size(); i++ ){
+      grounding_hashes[ i ] = _grounding_hash( searchSpace[ i ].second );
+    }
+  }
 
-    vector< pair< const Phrase*, vector< Grounding* > > > child_groundings;
-    for( unsigned int j = 0; j < child_solution_indices_cartesian_power[ i ].size(); j++ ){
-      solutions_vector.back().back().pygx *= _children[ j ]->solutions()[ child_solution_indices_cartesian_power[ i ][ j ] ].pygx;
-      child_groundings.push_back( pair< const Phrase*, vector< Grounding* > >( _children[ j ]->phrase(), vector< Grounding* >() ) );
-      for( unsigned int k = 0; k < _children[ j ]->solutions()[ child_solution_indices_cartesian_power[ i ][ j ] ].groundings.size(); k++ ){
-        child_groundings.back().second.push_back( _children[ j ]->solutions()[ child_solution_indices_cartesian_power[ i ][ j ] ].groundings[ k ] );
+  // the grounding-only features of each entry are read from the table rather than evaluated per combination
+  vector< const vector< vector< bool > >* > grounding_values( searchSpace.size(), NULL );
+  if( featureTable != NULL ){
+    for( unsigned int i = 0; i < searchSpace.size(); i++ ){
+      grounding_values[ i ] = featureTable->values( searchSpace[ i ].second );
+    }
+  }
+
+  // constraints are scored from partial sums over the features of their parent and child 
+  //   regions, which are evaluated once per region rather than once per constraint
+  Constraint_Scorer constraint_scorer;
+  vector< pair< unsigned int, unsigned int > > constraint_regions( searchSpace.size() );
+  vector< bool > factorized( searchSpace.size(), false );
+  if( featureTable != NULL ){
+    for( unsigned int i = 0; i < searchSpace.size(); i++ ){
+      if( featureTable->constraint_regions( searchSpace[ i ].second, constraint_regions[ i ].first, constraint_regions[ i ].second ) ){
+        if( !constraint_scorer.prepared() && !constraint_scorer.prepare( llm, _phrase, world, context, correspondenceVariables[ searchSpace[ i ].first ] ) ){
+          break;
+        }
+        factorized[ i ] = ( correspondenceVariables[ searchSpace[ i ].first ] == constraint_scorer.cvs() );
+      }
+    }
+  }
+
+  // an entry with a mirror, the same constraint with the roles of its regions swapped, is 
+  //   one factor for the pair: false when neither orientation holds, true for the entry 
+  //   and inverted for the mirror; both orientations are scored with the same weights
+  vector< Grounding* > mirror_groundings( searchSpace.size(), NULL );
+  vector< const vector< vector< bool > >* > mirror_grounding_values( searchSpace.size(), NULL );
+  vector< double > mirror_values;
+  if( mirrors != NULL ){
+    for( unsigned int i = 0; i < searchSpace.size(); i++ ){
+      const vector< unsigned int >& cvs = correspondenceVariables[ searchSpace[ i ].first ];
+      if( ( ( *mirrors )[ i ] != NULL ) && ( find( cvs.begin(), cvs.end(), CV_FALSE ) != cvs.end() ) && ( find( cvs.begin(), cvs.end(), CV_TRUE ) != cvs.end() ) && ( find( cvs.begin(), cvs.end(), CV_INVERTED ) != cvs.end() ) ){
+        mirror_groundings[ i ] = ( *mirrors )[ i ];
+        if( ( featureTable != NULL ) && !factorized[ i ] ){
+          mirror_grounding_values[ i ] = featureTable->values( mirror_groundings[ i ] );
+        }
       }
     }
+  }
+
+  // every factor is at most one, so the product of the child solutions bounds a combination from above
+  vector< pair< double, pair< unsigned int, unsigned int > > > combinations( child_solution_indices_cartesian_power.size() );
+  for( unsigned int i = 0; i < child_solution_indices_cartesian_power.size(); i++ ){
+    combinations[ i ] = pair< double, pair< unsigned int, unsigned int > >( 1.0, pair< unsigned int, unsigned int >( i, 0 ) );
+    for( unsigned int j = 0; j < child_solution_indices_cartesian_power[ i ].size(); j++ ){
+      combinations[ i ].first *= _children[ j ]->solutions()[ child_solution_indices_cartesian_power[ i ][ j ] ].pygx;
+    }
+  }
+  stable_sort( combinations.begin(), combinations.end(), factor_set_candidate_sort );
+
+  // the incumbent is the beamWidth-th best score of the finished combinations, or the 
+  //   threshold below which the caller has no use for a solution
+  priority_queue< double, vector< double >, greater< double > > incumbents;
+  unsigned int num_pruned_combinations = 0;
+  for( unsigned int c = 0; c < combinations.size(); c++ ){
+    const unsigned int& i = combinations[ c ].second.first;
+    double incumbent = ( !incumbents.empty() && ( incumbents.size() >= beamWidth ) ) ? incumbents.top() : 0.0;
+    if( incumbent < threshold ){
+      incumbent = threshold;
+    }
+    if( combinations[ c ].first < incumbent ){
+      num_pruned_combinations = combinations.size() - c;
+      break;
+    }
 
-/*
-    vector< Grounding* > child_groundings;
+    vector< Factor_Set_Solution_Node >& nodes = nodes_vector[ i ];
+    vector< pair< double, int > >& beam = beams_vector[ i ];
+    beam.push_back( pair< double, int >( combinations[ c ].first, -1 ) );
+
+    vector< pair< const Phrase*, vector< Grounding* > > > child_groundings;
+    size_t child_groundings_hash = 0;
     for( unsigned int j = 0; j < child_solution_indices_cartesian_power[ i ].size(); j++ ){
-      solutions_vector.back().back().pygx *= _children[ j ]->solutions()[ child_solution_indices_cartesian_power[ i ][ j ] ].pygx;
-      for( unsigned int k = 0; k < _children[ j ]->solutions()[ child_solution_indices_cartesian_power[ i ][ j ] ].groundings.size(); k++ ){
-        child_groundings.push_back( _children[ j ]->solutions()[ child_solution_indices_cartesian_power[ i ][ j ] ].groundings[ k ] );
+      const Factor_Set_Solution& child_solution = _children[ j ]->solutions()[ child_solution_indices_cartesian_power[ i ][ j ] ];
+      child_groundings.push_back( pair< const Phrase*, vector< Grounding* > >( _children[ j ]->phrase(), child_solution.groundings ) );
+      if( _cache_scores ){
+        boost::hash_combine( child_groundings_hash, child_solution.groundings.size() );
+        for( unsigned int k = 0; k < child_solution.groundings.size(); k++ ){
+          boost::hash_combine( child_groundings_hash, _grounding_hash( child_solution.groundings[ k ] ) );
+        }
       }
     }
-*/    
+
+    bool regions_filled = false;
     for( unsigned int j = 0; j < searchSpace.size(); j++ ){
-      unsigned int num_solutions = solutions_vector.back().size();
-      for( unsigned int k = 1; k < correspondenceVariables[ searchSpace[ j ].first ].size(); k++ ){
-        for( unsigned int l = 0; l < num_solutions; l++ ){
-          solutions_vector.back().push_back( solutions_vector.back()[ l ] );
-        } 
-      }
-  
-      for( unsigned int k = 0; k < correspondenceVariables[ searchSpace[ j ].first ].size(); k++ ){
-        double value = llm->pygx( correspondenceVariables[ searchSpace[ j ].first ][ k ], searchSpace[ j ].second, child_groundings, _phrase, world, context, correspondenceVariables[ searchSpace[ j ].first ], evaluate_feature_types );
+      // the remaining correspondences are left false once the budget expires; the 
+      //   clock is read for every 64th grounding rather than each one
+      if( ( budget != NULL ) && ( ( j % 64 ) == 0 ) && ( budget->expired() ) ){
+        _truncated = true;
+        break;
+      }
+      const vector< unsigned int >& cvs = correspondenceVariables[ searchSpace[ j ].first ];
+      size_t score_key = child_groundings_hash;
+      map< size_t, vector< double > >::const_iterator it_score = _scores.end();
+      if( _cache_scores ){
+        boost::hash_combine( score_key, grounding_hashes[ j ] );
+        it_score = _scores.find( score_key );
+      }
+      if( it_score != _scores.end() ){
+        values = it_score->second;
+      } else if( factorized[ j ] ){
+        if( !regions_filled ){
+          constraint_scorer.fill_regions( featureTable->regions(), child_groundings, _phrase, world, context );
+          regions_filled = true;
+        }
+        // the mirror reuses the region sums with the parent and child swapped and shares 
+        //   the features of the entry that do not depend on its regions
+        if( mirror_groundings[ j ] != NULL ){
+          constraint_scorer.pygx( searchSpace[ j ].second, mirror_groundings[ j ], constraint_regions[ j ].first, constraint_regions[ j ].second, child_groundings, _phrase, world, context, grounding_values[ j ], values, mirror_values );
+        } else {
+          constraint_scorer.pygx( searchSpace[ j ].second, constraint_regions[ j ].first, constraint_regions[ j ].second, child_groundings, _phrase, world, context, grounding_values[ j ], values );
+        }
+        _num_scored++;
+      } else {
+        llm->pygx( searchSpace[ j ].second, child_groundings, _phrase, world, context, cvs, evaluate_feature_types, values, grounding_values[ j ] );
         evaluate_feature_types[ FEATURE_TYPE_LANGUAGE ] = false;
-        for( unsigned int l = 0; l < num_solutions; l++ ){
-          solutions_vector.back()[ k * num_solutions + l ].cv[ correspondenceVariables[ searchSpace[ j ].first ][ k ] ].push_back( j ); 
-          solutions_vector.back()[ k * num_solutions + l ].pygx *= value; 
+        _num_scored++;
+        if( mirror_groundings[ j ] != NULL ){
+          llm->pygx( mirror_groundings[ j ], child_groundings, _phrase, world, context, cvs, evaluate_feature_types, mirror_values, mirror_grounding_values[ j ] );
+          _num_scored++;
         }
       }
-      
-      sort( solutions_vector.back().begin(), solutions_vector.back().end(), factor_set_solution_sort );   
-      
-      if( solutions_vector.back().size() > beamWidth ){
-        solutions_vector.back().erase( solutions_vector.back().begin() + beamWidth, solutions_vector.back().end() );
+      if( ( it_score == _scores.end() ) && ( mirror_groundings[ j ] != NULL ) ){
+        _pair_values( cvs, mirror_values, values );
+      }
+      if( _cache_scores ){
+        scores[ score_key ] = values;
+      }
+
+      candidates.clear();
+      for( unsigned int k = 0; k < cvs.size(); k++ ){
+        for( unsigned int l = 0; l < beam.size(); l++ ){
+          candidates.push_back( pair< double, pair< unsigned int, unsigned int > >( beam[ l ].first * values[ k ], pair< unsigned int, unsigned int >( k, l ) ) );
+        }
+      }
+      sort( candidates.begin(), candidates.end(), factor_set_candidate_sort );
+      unsigned int beam_width = _beam_width( candidates, beamWidth );
+      if( candidates.size() > beam_width ){
+        candidates.erase( candidates.begin() + beam_width, candidates.end() );
+      }
+
+      vector< pair< double, int > > next_beam( candidates.size() );
+      for( unsigned int k = 0; k < candidates.size(); k++ ){
+        const unsigned int& cv = cvs[ candidates[ k ].second.first ];
+        next_beam[ k ].first = candidates[ k ].first;
+        next_beam[ k ].second = beam[ candidates[ k ].second.second ].second;
+        if( cv != CV_FALSE ){
+          nodes.push_back( Factor_Set_Solution_Node( next_beam[ k ].second, j, cv ) );
+          next_beam[ k ].second = nodes.size() - 1;
+        }
+      }
+      beam.swap( next_beam );
+
+      // partial solutions only lose probability, so those below the incumbent can never be kept 
+      while( !beam.empty() && ( beam.back().first < incumbent ) ){
+        beam.pop_back();
+      }
+      if( beam.empty() ){
+        break;
+      }
+    }
+
+    for( unsigned int j = 0; j < beam.size(); j++ ){
+      if( incumbents.size() < beamWidth ){
+        incumbents.push( beam[ j ].first );
+      } else if( beam[ j ].first > incumbents.top() ){
+        incumbents.pop();
+        incumbents.push( beam[ j ].first );
       }
     }
   }
 
+  // only the scores of this search are kept, so stale groundings do not accumulate
+  if( _cache_scores ){
+    _scores.swap( scores );
+  }
+
   // flatten solutions
-  _solutions.clear();
-  for( unsigned int i = 0; i < solutions_vector.size(); i++ ){
-    for( unsigned int j = 0; j < solutions_vector[ i ].size(); j++ ){
-      _solutions.push_back( solutions_vector[ i ][ j ] );
+  vector< pair< double, pair< unsigned int, unsigned int > > > flattened;
+  for( unsigned int i = 0; i < beams_vector.size(); i++ ){
+    for( unsigned int j = 0; j < beams_vector[ i ].size(); j++ ){
+      flattened.push_back( pair< double, pair< unsigned int, unsigned int > >( beams_vector[ i ][ j ].first, pair< unsigned int, unsigned int >( i, j ) ) );
     }
   } 
 
   if( debug ){
-    cout << "  sorting through " << _solutions.size() << " solutions for \"" << _phrase->words_to_std_string() << "\"" << endl;
+    if( _cache_scores ){
+      cout << "  scored " << _num_scored << " of " << scores.size() << " groundings for \"" << _phrase->words_to_std_string() << "\"" << endl;
+    }
+    cout << "  pruned " << num_pruned_combinations << " of " << combinations.size() << " child combinations for \"" << _phrase->words_to_std_string() << "\"" << endl;
+    cout << "  sorting through " << flattened.size() << " solutions for \"" << _phrase->words_to_std_string() << "\"" << endl;
   }
 
-  sort( _solutions.begin(), _solutions.end(), factor_set_solution_sort );
-  if( _solutions.size() > beamWidth ){
-    _solutions.erase( _solutions.begin() + beamWidth, _solutions.end() );
+  sort( flattened.begin(), flattened.end(), factor_set_candidate_sort );
+  unsigned int beam_width = _beam_width( flattened, beamWidth );
+  if( flattened.size() > beam_width ){
+    flattened.erase( flattened.begin() + beam_width, flattened.end() );
   }
 
-  for( unsigned int i = 0; i < _solutions.size(); i++ ){
-    for( unsigned int j = 0; j < _solutions[ i ].cv[ CV_TRUE ].size(); j++ ){
-      _solutions[ i ].groundings.push_back( searchSpace[ _solutions[ i ].cv[ CV_TRUE ][ j ] ].second );
+  if( debug ){
+    cout << "  beam width " << flattened.size() << " (max " << beamWidth << ") for \"" << _phrase->words_to_std_string() << "\"" << endl;
+  }
+
+  // only the surviving solutions are expanded into full correspondence variable sets
+  _solutions.clear();
+  for( unsigned int i = 0; i < flattened.size(); i++ ){
+    const unsigned int& combination = flattened[ i ].second.first;
+    _solutions.push_back( Factor_Set_Solution() );
+    _solutions.back().children = child_solution_indices_cartesian_power[ combination ];
+    _solutions.back().pygx = flattened[ i ].first;
+    _materialize_solution( nodes_vector[ combination ], beams_vector[ combination ][ flattened[ i ].second.second ].second, searchSpace.size(), _solutions.back() );
+    for( unsigned int j = 0; j < _solutions.back().cv[ CV_TRUE ].size(); j++ ){
+      _solutions.back().groundings.push_back( searchSpace[ _solutions.back().cv[ CV_TRUE ][ j ] ].second );
     }
   }
 
@@ -240,6 +439,102 @@ search( const vector< pair< unsigned int, Grounding* > >& searchSpace,
   return;
 }
 
+/**
+ * returns the number of sorted candidates needed to hold beam_mass() of their 
+ *   probability, bounded by min_beam_width() and maxBeamWidth
+ */
+unsigned int
+Factor_Set::
+_beam_width( const vector< pair< double, pair< unsigned int, unsigned int > > >& candidates,
+              const unsigned int& maxBeamWidth )const{
+  if( _beam_mass >= 1.0 ){
+    return maxBeamWidth;
+  }
+
+  double pygx_sum = 0.0;
+  for( unsigned int i = 0; i < candidates.size(); i++ ){
+    pygx_sum += candidates[ i ].first;
+  }
+  if( pygx_sum <= 0.0 ){
+    return maxBeamWidth;
+  }
+
+  unsigned int beam_width = 0;
+  double pygx_mass = 0.0;
+  while( ( beam_width < candidates.size() ) && ( beam_width < maxBeamWidth ) && ( pygx_mass < _beam_mass * pygx_sum ) ){
+    pygx_mass += candidates[ beam_width ].first;
+    beam_width++;
+  }
+  if( beam_width < _min_beam_width ){
+    beam_width = ( _min_beam_width < maxBeamWidth ) ? _min_beam_width : maxBeamWidth;
+  }
+  return beam_width;
+}
+
+size_t
+Factor_Set::
+_grounding_hash( const Grounding* grounding ){
+  if( dynamic_cast< const Region* >( grounding ) != NULL ){
+    return dynamic_cast< const Region* >( grounding )->hash();
+  } else if( dynamic_cast< const Constraint* >( grounding ) != NULL ){
+    return dynamic_cast< const Constraint* >( grounding )->hash();
+  } else if( dynamic_cast< const Object* >( grounding ) != NULL ){
+    return dynamic_cast< const Object* >( grounding )->hash();
+  } else {
+    return boost::hash< const Grounding* >()( grounding );
+  }
+}
+
+/**
+ * combines the scores of a constraint and its mirror into the scores of the pair, leaving 
+ *   out the assignment with both orientations true
+ */
+void
+Factor_Set::
+_pair_values( const vector< unsigned int >& cvs,
+              const vector< double >& mirrorValues,
+              vector< double >& values ){
+  unsigned int false_index = find( cvs.begin(), cvs.end(), CV_FALSE ) - cvs.begin();
+  unsigned int true_index = find( cvs.begin(), cvs.end(), CV_TRUE ) - cvs.begin();
+  unsigned int inverted_index = find( cvs.begin(), cvs.end(), CV_INVERTED ) - cvs.begin();
+  double value_false = values[ false_index ];
+  double value_true = values[ true_index ];
+  values[ false_index ] = value_false * mirrorValues[ false_index ];
+  values[ true_index ] = value_true * mirrorValues[ false_index ];
+  values[ inverted_index ] = value_false * mirrorValues[ true_index ];
+  return;
+}
+
+void
+Factor_Set::
+_materialize_solution( const vector< Factor_Set_Solution_Node >& nodes,
+                        const int& node,
+                        const unsigned int& searchSpaceSize,
+                        Factor_Set_Solution& solution )const{
+  solution.cv.clear();
+  solution.cv.resize( NUM_CVS );
+
+  vector< int > chain;
+  for( int i = node; i >= 0; i = nodes[ i ].parent ){
+    chain.push_back( i );
+  }
+
+  // walk the chain from the first search space entry, filling in the implied false correspondences
+  unsigned int next_index = 0;
+  for( vector< int >::reverse_iterator it = chain.rbegin(); it != chain.rend(); it++ ){
+    const Factor_Set_Solution_Node& chain_node = nodes[ *it ];
+    for( unsigned int i = next_index; i < chain_node.index; i++ ){
+      solution.cv[ CV_FALSE ].push_back( i );
+    }
+    solution.cv[ chain_node.cv ].push_back( chain_node.index );
+    next_index = chain_node.index + 1;
+  }
+  for( unsigned int i = next_index; i < searchSpaceSize; i++ ){
+    solution.cv[ CV_FALSE ].push_back( i );
+  }
+  return;
+}
+
 namespace h2sl {
   ostream&
   operator<<( ostream& out,
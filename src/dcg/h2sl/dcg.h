@@ -37,11 +37,17 @@
 
 #include <iostream>
 #include <vector>
+#include <list>
+#include <map>
 
 #include "h2sl/phrase.h"
 #include "h2sl/world.h"
 #include "h2sl/llm.h"
 #include "h2sl/factor_set.h"
+#include "h2sl/search_space.h"
+#include "h2sl/search_space_filter.h"
+#include "h2sl/lexical_object_filter.h"
+#include "h2sl/solution_cache.h"
 
 namespace h2sl {
   class DCG {
@@ -52,25 +58,89 @@ namespace h2sl {
     DCG& operator=( const DCG& other );
 
     virtual void fill_search_spaces( const World* world );
-    virtual bool leaf_search( const Phrase* phrase, const World* world, LLM* llm, const unsigned int beamWidth = 4, const bool& debug = false );
-    virtual bool leaf_search( const Phrase* phrase, const World* world, const Grounding* context, LLM* llm, const unsigned int beamWidth = 4, const bool& debug = false );
+    virtual void clear_search_spaces( void );
+    virtual bool leaf_search( const Phrase* phrase, const World* world, LLM* llm, const unsigned int beamWidth = 4, const bool& debug = false, const Search_Budget* budget = NULL );
+    virtual bool leaf_search( const Phrase* phrase, const World* world, const Grounding* context, LLM* llm, const unsigned int beamWidth = 4, const bool& debug = false, const Search_Budget* budget = NULL );
+    virtual bool leaf_search( const std::vector< Phrase* >& phrases, const World* world, LLM* llm, const unsigned int beamWidth = 4, const bool& debug = false, const Search_Budget* budget = NULL );
+    virtual bool leaf_search( const std::vector< Phrase* >& phrases, const World* world, const Grounding* context, LLM* llm, const unsigned int beamWidth = 4, const bool& debug = false, const Search_Budget* budget = NULL );
+    virtual bool update( const World* world, const World_Diff& diff, LLM* llm, const unsigned int beamWidth = 4, const bool& debug = false, const Search_Budget* budget = NULL );
+    virtual bool update( const World* world, const World_Diff& diff, const Grounding* context, LLM* llm, const unsigned int beamWidth = 4, const bool& debug = false, const Search_Budget* budget = NULL );
 
     virtual void to_latex( const std::string& filename )const;
 
-    inline const std::vector< std::vector< unsigned int > >& correspondence_variables( void )const{ return _correspondence_variables; };
-    inline const std::vector< std::pair< unsigned int, Grounding* > >& search_spaces( void )const{ return _search_spaces; };
+    inline const std::vector< std::vector< unsigned int > >& correspondence_variables( void )const{ return _search_space->correspondence_variables(); };
+    inline const std::vector< std::pair< unsigned int, Grounding* > >& search_spaces( void )const{ return _search_space->groundings(); };
+    inline const Search_Space* search_space( void )const{ return _search_space; };
+    inline const std::list< Search_Space* >& search_space_cache( void )const{ return _search_space_cache; };
+    inline Search_Space_Filter& search_space_filter( void ){ return _search_space_filter; };
+    inline const Search_Space_Filter& search_space_filter( void )const{ return _search_space_filter; };
+    inline bool& adaptive_constraints( void ){ return _adaptive_constraints; };
+    inline const bool& adaptive_constraints( void )const{ return _adaptive_constraints; };
+    inline double& adaptive_constraints_confidence( void ){ return _adaptive_constraints_confidence; };
+    inline const double& adaptive_constraints_confidence( void )const{ return _adaptive_constraints_confidence; };
+    inline bool& lexical_object_pruning( void ){ return _lexical_object_pruning; };
+    inline const bool& lexical_object_pruning( void )const{ return _lexical_object_pruning; };
+    inline Lexical_Object_Filter& lexical_object_filter( void ){ return _lexical_object_filter; };
+    inline const Lexical_Object_Filter& lexical_object_filter( void )const{ return _lexical_object_filter; };
+    inline unsigned int& min_beam_width( void ){ return _min_beam_width; };
+    inline const unsigned int& min_beam_width( void )const{ return _min_beam_width; };
+    inline double& beam_mass( void ){ return _beam_mass; };
+    inline const double& beam_mass( void )const{ return _beam_mass; };
+    inline bool& canonical_constraints( void ){ return _canonical_constraints; };
+    inline const bool& canonical_constraints( void )const{ return _canonical_constraints; };
+    inline bool& incremental( void ){ return _incremental; };
+    inline const bool& incremental( void )const{ return _incremental; };
+    inline const unsigned int& num_scored( void )const{ return _num_scored; };
+    inline unsigned int& search_space_cache_size( void ){ return _search_space_cache_size; };
+    inline const unsigned int& search_space_cache_size( void )const{ return _search_space_cache_size; };
     inline const std::vector< std::pair< double, Phrase* > >& solutions( void )const{ return _solutions; };
     inline const Factor_Set* root( void )const{ return _root; };
+    inline const bool& truncated( void )const{ return _truncated; };
+    inline const unsigned int& parse_index( void )const{ return _parse_index; };
+    inline const unsigned int& num_abandoned_parses( void )const{ return _num_abandoned_parses; };
+    inline const unsigned int& num_reused_subtrees( void )const{ return _num_reused_subtrees; };
+    inline Solution_Cache& solution_cache( void ){ return _solution_cache; };
+    inline const Solution_Cache& solution_cache( void )const{ return _solution_cache; };
 
   protected:
+    virtual bool _search_factors( Factor_Set* root, const World* world, const Grounding* context, LLM* llm, const unsigned int beamWidth, const bool& debug, const Search_Budget* budget, const double& incumbent = 0.0 );
+    virtual double _upper_bound( const Factor_Set* node, const Factor_Set* leaf )const;
+    virtual std::size_t _query_key( const LLM* llm )const;
+    virtual std::size_t _subtree_key( const Factor_Set* node, const World* world, const Grounding* context )const;
+    virtual void _subtree_structure( const Factor_Set* node, std::string& structure )const;
+    virtual void _store_subtree( const Factor_Set* node, std::vector< std::vector< Factor_Set_Solution > >& solutions )const;
+    virtual void _restore_subtree( Factor_Set* node, const std::vector< std::vector< Factor_Set_Solution > >& solutions, unsigned int& index )const;
+    virtual void _clear_solutions( void );
+    virtual void _clear_factor_solutions( Factor_Set* node );
+    virtual void _add_mirrored_groundings( Factor_Set* node, const std::vector< std::pair< unsigned int, Grounding* > >& searchSpace )const;
+    virtual void _fill_solutions( void );
     virtual void _find_leaf( Factor_Set* node, Factor_Set*& leaf );
     virtual void _fill_phrase( Factor_Set* node, Factor_Set_Solution& solution, Phrase* phrase );
     virtual void _fill_factors( Factor_Set* node, const Phrase* phrase, const bool& fill = false );
+    virtual void _filter_search_space( const Factor_Set* node, const LLM* llm, std::vector< std::pair< unsigned int, Grounding* > >& searchSpace, const bool& reduceCoverage = false )const;
+    virtual bool _fill_adaptive_constraints( const Factor_Set* node, std::vector< std::pair< unsigned int, Grounding* > >& searchSpace )const;
 
-    std::vector< std::pair< unsigned int, Grounding* > > _search_spaces;
-    std::vector< std::vector< unsigned int > > _correspondence_variables;
+    Search_Space * _search_space;
+    std::list< Search_Space* > _search_space_cache;
+    unsigned int _search_space_cache_size;
+    Search_Space_Filter _search_space_filter;
+    bool _adaptive_constraints;
+    double _adaptive_constraints_confidence;
+    bool _lexical_object_pruning;
+    Lexical_Object_Filter _lexical_object_filter;
+    unsigned int _min_beam_width;
+    double _beam_mass;
     std::vector< std::pair< double, Phrase* > > _solutions;
     Factor_Set * _root;
+    bool _truncated;
+    unsigned int _parse_index;
+    unsigned int _num_abandoned_parses;
+    std::map< std::size_t, Factor_Set_Subtree_Solutions > _subtree_memo;
+    unsigned int _num_reused_subtrees;
+    Solution_Cache _solution_cache;
+    bool _incremental;
+    unsigned int _num_scored;
+    bool _canonical_constraints;
   
   private:
 
@@ -36,14 +36,32 @@
 
 #include <iostream>
 #include <vector>
+#include <map>
 #include <algorithm>
 
 #include "h2sl/grounding.h"
 #include "h2sl/phrase.h"
 #include "h2sl/world.h"
 #include "h2sl/llm.h"
+#include "h2sl/feature_table.h"
+#include "h2sl/constraint_scorer.h"
+#include "h2sl/search_budget.h"
 
 namespace h2sl {
+  /**
+   * a link in the delta chain of a partial solution; only non-false 
+   *   correspondences are recorded, the false ones are implied
+   */
+  class Factor_Set_Solution_Node {
+  public:
+    Factor_Set_Solution_Node( const int& parent = -1, const unsigned int& index = 0, const unsigned int& cv = CV_UNKNOWN ) : parent( parent ), index( index ), cv( cv ) {};
+    virtual ~Factor_Set_Solution_Node(){};
+
+    int parent;
+    unsigned int index;
+    unsigned int cv;
+  };
+
   class Factor_Set_Solution {
   public:
     Factor_Set_Solution();
@@ -57,6 +75,21 @@ namespace h2sl {
     double pygx;
   };
 
+  /**
+   * the solutions of a searched subtree in preorder, with the beam width and 
+   *   threshold they were searched with
+   */
+  class Factor_Set_Subtree_Solutions {
+  public:
+    Factor_Set_Subtree_Solutions( const std::string& subtree = "", const unsigned int& beamWidth = 0, const double& threshold = 0.0 ) : subtree( subtree ), solutions(), beam_width( beamWidth ), threshold( threshold ) {};
+    virtual ~Factor_Set_Subtree_Solutions(){};
+
+    std::string subtree;
+    std::vector< std::vector< Factor_Set_Solution > > solutions;
+    unsigned int beam_width;
+    double threshold;
+  };
+
   class Factor_Set {
   public:
     Factor_Set( const Phrase* phrase = NULL );
@@ -64,8 +97,8 @@ namespace h2sl {
     Factor_Set( const Factor_Set& other );
     Factor_Set& operator=( const Factor_Set& other );
 
-    virtual void search( const std::vector< std::pair< unsigned int, Grounding* > >& searchSpace, const std::vector< std::vector< unsigned int > >& correspondenceVariables, const World* world, LLM* llm, const unsigned int beamWidth = 4, const bool& debug = false );
-    virtual void search( const std::vector< std::pair< unsigned int, Grounding* > >& searchSpace, const std::vector< std::vector< unsigned int > >& correspondenceVariables, const World* world, const Grounding* context, LLM* llm, const unsigned int beamWidth = 4, const bool& debug = false );
+    virtual void search( const std::vector< std::pair< unsigned int, Grounding* > >& searchSpace, const std::vector< std::vector< unsigned int > >& correspondenceVariables, const World* world, LLM* llm, const unsigned int beamWidth = 4, const bool& debug = false, const Search_Budget* budget = NULL, const double& threshold = 0.0, const Feature_Table* featureTable = NULL, const std::vector< Grounding* >* mirrors = NULL );
+    virtual void search( const std::vector< std::pair< unsigned int, Grounding* > >& searchSpace, const std::vector< std::vector< unsigned int > >& correspondenceVariables, const World* world, const Grounding* context, LLM* llm, const unsigned int beamWidth = 4, const bool& debug = false, const Search_Budget* budget = NULL, const double& threshold = 0.0, const Feature_Table* featureTable = NULL, const std::vector< Grounding* >* mirrors = NULL );
 
     inline const Phrase* phrase( void )const{ return _phrase; };
 
@@ -74,11 +107,31 @@ namespace h2sl {
 
     inline std::vector< Factor_Set_Solution >& solutions( void ){ return _solutions; };
     inline const std::vector< Factor_Set_Solution >& solutions( void )const{ return _solutions; };
+    inline const bool& truncated( void )const{ return _truncated; };
+    inline unsigned int& min_beam_width( void ){ return _min_beam_width; };
+    inline const unsigned int& min_beam_width( void )const{ return _min_beam_width; };
+    inline double& beam_mass( void ){ return _beam_mass; };
+    inline const double& beam_mass( void )const{ return _beam_mass; };
+    inline bool& cache_scores( void ){ return _cache_scores; };
+    inline const bool& cache_scores( void )const{ return _cache_scores; };
+    inline const std::map< std::size_t, std::vector< double > >& scores( void )const{ return _scores; };
+    inline const unsigned int& num_scored( void )const{ return _num_scored; };
 
   protected:
+    unsigned int _beam_width( const std::vector< std::pair< double, std::pair< unsigned int, unsigned int > > >& candidates, const unsigned int& maxBeamWidth )const;
+    void _materialize_solution( const std::vector< Factor_Set_Solution_Node >& nodes, const int& node, const unsigned int& searchSpaceSize, Factor_Set_Solution& solution )const;
+    static std::size_t _grounding_hash( const Grounding* grounding );
+    static void _pair_values( const std::vector< unsigned int >& cvs, const std::vector< double >& mirrorValues, std::vector< double >& values );
+
     const Phrase* _phrase;
     std::vector< Factor_Set* > _children;
     std::vector< Factor_Set_Solution > _solutions;
+    bool _truncated;
+    unsigned int _min_beam_width;
+    double _beam_mass;
+    bool _cache_scores;
+    std::map< std::size_t, std::vector< double > > _scores;
+    unsigned int _num_scored;
 
   private:
 
@@ -0,0 +1,73 @@
+/**
+ * @file    lexical_object_filter.h
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The interface for a class used to bound the object types that a phrase
+ *   can refer to from its words and the weights of a log-linear model
+ */
+
+#ifndef H2SL_LEXICAL_OBJECT_FILTER_H
+#define H2SL_LEXICAL_OBJECT_FILTER_H
+
+#include <iostream>
+#include <vector>
+
+#include "h2sl/phrase.h"
+#include "h2sl/llm.h"
+
+namespace h2sl {
+  /**
+   * an object type is in the bound of a phrase if a word in the phrase or 
+   *   its children has a weight above the threshold for a true 
+   *   correspondence with an object_type property feature of that type
+   */
+  class Lexical_Object_Filter {
+  public:
+    Lexical_Object_Filter( const double& threshold = 0.0 );
+    virtual ~Lexical_Object_Filter();
+    Lexical_Object_Filter( const Lexical_Object_Filter& other );
+    Lexical_Object_Filter& operator=( const Lexical_Object_Filter& other );
+
+    virtual bool object_types( const Phrase* phrase, const LLM* llm, std::vector< std::string >& objectTypes )const;
+
+    inline double& threshold( void ){ return _threshold; };
+    inline const double& threshold( void )const{ return _threshold; };
+
+  protected:
+    void _scrape_words( const Phrase* phrase, std::vector< Word >& words )const;
+
+    double _threshold;
+
+  private:
+
+  };
+  std::ostream& operator<<( std::ostream& out, const Lexical_Object_Filter& other );
+}
+
+#endif /* H2SL_LEXICAL_OBJECT_FILTER_H */
@@ -0,0 +1,75 @@
+/**
+ * @file    search_budget.h
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The interface for a class used to bound the time spent searching a 
+ *   Distributed Correspondence Graph
+ */
+
+#ifndef H2SL_SEARCH_BUDGET_H
+#define H2SL_SEARCH_BUDGET_H
+
+#include <iostream>
+#include <time.h>
+#include <boost/thread/mutex.hpp>
+
+namespace h2sl {
+  /**
+   * a deadline measured from construction (or restart()) and a cancellation 
+   *   flag that may be set from another thread; a duration of zero never expires 
+   */
+  class Search_Budget {
+  public:
+    Search_Budget( const double& duration = 0.0 );
+    virtual ~Search_Budget();
+    Search_Budget( const Search_Budget& other );
+    Search_Budget& operator=( const Search_Budget& other );
+
+    void restart( void );
+    void cancel( void );
+    bool cancelled( void )const;
+    bool expired( void )const;
+    double elapsed( void )const;
+    double remaining_fraction( void )const;
+
+    inline const double& duration( void )const{ return _duration; };
+
+  protected:
+    double _duration;
+    struct timespec _start_time;
+    bool _cancelled;
+    mutable boost::mutex _mutex;
+
+  private:
+
+  };
+  std::ostream& operator<<( std::ostream& out, const Search_Budget& other );
+}
+
+#endif /* H2SL_SEARCH_BUDGET_H */
@@ -0,0 +1,106 @@
+/**
+ * @file    search_space.h
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The interface for a class used to represent the search space of a 
+ *   Distributed Correspondence Graph for a single world
+ */
+
+#ifndef H2SL_SEARCH_SPACE_H
+#define H2SL_SEARCH_SPACE_H
+
+#include <iostream>
+#include <vector>
+
+#include "h2sl/grounding.h"
+#include "h2sl/region.h"
+#include "h2sl/constraint.h"
+#include "h2sl/world.h"
+#include "h2sl/world_diff.h"
+#include "h2sl/feature_table.h"
+
+namespace h2sl {
+  /**
+   * the groundings are stored by value in contiguous arrays sized before 
+   *   they are filled, so the pointers in groundings() remain valid for the 
+   *   lifetime of the search space and are released together; partitions()
+   *   gives the [begin,end) range of groundings() for each grounding class;
+   *   feature_table() holds the grounding-only feature values of these 
+   *   pointers and is emptied whenever the groundings change
+   */
+  class Search_Space {
+  public:
+    Search_Space();
+    virtual ~Search_Space();
+    Search_Space( const Search_Space& other );
+    Search_Space& operator=( const Search_Space& other );
+
+    virtual void fill( const World* world );
+    virtual bool update( const World* world, const World_Diff& diff );
+    virtual void clear( void );
+
+    bool region_indices( const Grounding* grounding, unsigned int& objectIndex, unsigned int& regionTypeIndex )const;
+    unsigned int constraint_index( const unsigned int& constraintTypeIndex, const unsigned int& parentObjectIndex, const unsigned int& parentRegionTypeIndex, const unsigned int& childObjectIndex, const unsigned int& childRegionTypeIndex )const;
+    bool is_canonical( const unsigned int& index )const;
+    unsigned int mirror_index( const unsigned int& index )const;
+    Grounding* mirror( const Grounding* grounding )const;
+
+    inline const std::vector< std::vector< unsigned int > >& correspondence_variables( void )const{ return _correspondence_variables; };
+    inline const std::vector< std::pair< unsigned int, Grounding* > >& groundings( void )const{ return _groundings; };
+    inline const std::vector< std::pair< std::string, std::pair< unsigned int, unsigned int > > >& partitions( void )const{ return _partitions; };
+    inline const std::vector< Region >& regions( void )const{ return _regions; };
+    inline const std::vector< Constraint >& constraints( void )const{ return _constraints; };
+    inline const std::vector< std::string >& region_types( void )const{ return _region_types; };
+    inline const std::vector< std::string >& constraint_types( void )const{ return _constraint_types; };
+    inline const unsigned int& num_objects( void )const{ return _num_objects; };
+    inline const std::size_t& world_hash( void )const{ return _world_hash; };
+    inline Feature_Table& feature_table( void ){ return _feature_table; };
+    inline const Feature_Table& feature_table( void )const{ return _feature_table; };
+
+  protected:
+    void _fill_groundings( void );
+
+    std::vector< std::vector< unsigned int > > _correspondence_variables;
+    std::vector< std::string > _region_types;
+    std::vector< std::string > _constraint_types;
+    unsigned int _num_objects;
+    std::vector< Region > _regions;
+    std::vector< Constraint > _constraints;
+    std::vector< std::pair< unsigned int, Grounding* > > _groundings;
+    std::vector< std::pair< std::string, std::pair< unsigned int, unsigned int > > > _partitions;
+    std::size_t _world_hash;
+    Feature_Table _feature_table;
+
+  private:
+
+  };
+  std::ostream& operator<<( std::ostream& out, const Search_Space& other );
+}
+
+#endif /* H2SL_SEARCH_SPACE_H */
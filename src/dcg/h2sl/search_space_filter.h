@@ -0,0 +1,79 @@
+/**
+ * @file    search_space_filter.h
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The interface for a class used to restrict the grounding classes that
+ *   are searched for each phrase type
+ */
+
+#ifndef H2SL_SEARCH_SPACE_FILTER_H
+#define H2SL_SEARCH_SPACE_FILTER_H
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <libxml/tree.h>
+
+#include "h2sl/phrase.h"
+
+namespace h2sl {
+  /**
+   * phrase types without an entry are not filtered
+   */
+  class Search_Space_Filter {
+  public:
+    Search_Space_Filter();
+    virtual ~Search_Space_Filter();
+    Search_Space_Filter( const Search_Space_Filter& other );
+    Search_Space_Filter& operator=( const Search_Space_Filter& other );
+
+    virtual void learn( const Phrase* phrase );
+    virtual bool has_phrase_type( const phrase_type_t& phraseType )const;
+    virtual bool allows( const phrase_type_t& phraseType, const std::string& groundingClass )const;
+    virtual void clear( void );
+
+    virtual void to_xml( const std::string& filename )const;
+    virtual void to_xml( xmlDocPtr doc, xmlNodePtr root )const;
+
+    virtual void from_xml( const std::string& filename );
+    virtual void from_xml( xmlNodePtr root );
+
+    inline std::map< phrase_type_t, std::vector< std::string > >& grounding_classes( void ){ return _grounding_classes; };
+    inline const std::map< phrase_type_t, std::vector< std::string > >& grounding_classes( void )const{ return _grounding_classes; };
+
+  protected:
+    std::map< phrase_type_t, std::vector< std::string > > _grounding_classes;
+
+  private:
+
+  };
+  std::ostream& operator<<( std::ostream& out, const Search_Space_Filter& other );
+}
+
+#endif /* H2SL_SEARCH_SPACE_FILTER_H */
@@ -0,0 +1,95 @@
+/**
+ * @file    solution_cache.h
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The interface for a class used to cache the solutions of grounded
+ *   subtrees across queries
+ */
+
+#ifndef H2SL_SOLUTION_CACHE_H
+#define H2SL_SOLUTION_CACHE_H
+
+#include <iostream>
+#include <list>
+#include <map>
+
+#include "h2sl/factor_set.h"
+
+namespace h2sl {
+  /**
+   * a cached subtree, with the query it was searched for and the content hash 
+   *   of the world whose search space its groundings point into
+   */
+  class Solution_Cache_Entry {
+  public:
+    Solution_Cache_Entry( const std::size_t& key = 0, const std::size_t& queryKey = 0, const std::size_t& worldHash = 0, const Factor_Set_Subtree_Solutions& subtreeSolutions = Factor_Set_Subtree_Solutions() ) : key( key ), query_key( queryKey ), world_hash( worldHash ), subtree_solutions( subtreeSolutions ) {};
+    virtual ~Solution_Cache_Entry(){};
+
+    std::size_t key;
+    std::size_t query_key;
+    std::size_t world_hash;
+    Factor_Set_Subtree_Solutions subtree_solutions;
+  };
+
+  /**
+   * a bounded cache of subtree solutions, most recently used first; a size 
+   *   of zero disables the cache, which is the default
+   */
+  class Solution_Cache {
+  public:
+    Solution_Cache( const unsigned int& size = 0 );
+    virtual ~Solution_Cache();
+    Solution_Cache( const Solution_Cache& other );
+    Solution_Cache& operator=( const Solution_Cache& other );
+
+    const Factor_Set_Subtree_Solutions* find( const std::size_t& key, const std::size_t& queryKey, const std::string& subtree, const unsigned int& beamWidth, const double& threshold );
+    void insert( const std::size_t& key, const std::size_t& queryKey, const std::size_t& worldHash, const Factor_Set_Subtree_Solutions& subtreeSolutions );
+    void erase_world( const std::size_t& worldHash );
+    void clear( void );
+
+    inline unsigned int& size( void ){ return _size; };
+    inline const unsigned int& size( void )const{ return _size; };
+    inline const std::list< Solution_Cache_Entry >& entries( void )const{ return _entries; };
+    inline const unsigned int& num_hits( void )const{ return _num_hits; };
+    inline const unsigned int& num_misses( void )const{ return _num_misses; };
+
+  protected:
+    unsigned int _size;
+    std::list< Solution_Cache_Entry > _entries;
+    std::map< std::size_t, std::list< Solution_Cache_Entry >::iterator > _index;
+    unsigned int _num_hits;
+    unsigned int _num_misses;
+
+  private:
+
+  };
+  std::ostream& operator<<( std::ostream& out, const Solution_Cache& other );
+}
+
+#endif /* H2SL_SOLUTION_CACHE_H */
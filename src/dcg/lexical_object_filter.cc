@@ -0,0 +1,143 @@
+/**
+ * @file    lexical_object_filter.cc
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of a class used to bound the object types that a 
+ *   phrase can refer to from its words and the weights of a log-linear model
+ */
+
+#include <algorithm>
+
+#include "h2sl/feature_cv.h"
+#include "h2sl/feature_word.h"
+#include "h2sl/feature_grounding_property_value.h"
+#include "h2sl/lexical_object_filter.h"
+
+using namespace std;
+using namespace h2sl;
+
+Lexical_Object_Filter::
+Lexical_Object_Filter( const double& threshold ) : _threshold( threshold ) {
+
+}
+
+Lexical_Object_Filter::
+~Lexical_Object_Filter() {
+
+}
+
+Lexical_Object_Filter::
+Lexical_Object_Filter( const Lexical_Object_Filter& other ) : _threshold( other._threshold ) {
+
+}
+
+Lexical_Object_Filter&
+Lexical_Object_Filter::
+operator=( const Lexical_Object_Filter& other ) {
+  _threshold = other._threshold;
+  return (*this);
+}
+
+/**
+ * fills the object types in the bound of the phrase; returns false when none 
+ *   of the words bound the object types, in which case nothing should be pruned
+ */
+bool
+Lexical_Object_Filter::
+object_types( const Phrase* phrase,
+              const LLM* llm,
+              vector< string >& objectTypes )const{
+  objectTypes.clear();
+  if( ( phrase == NULL ) || ( llm == NULL ) || ( llm->feature_set() == NULL ) ){
+    return false;
+  }
+
+  vector< Word > words;
+  _scrape_words( phrase, words );
+  if( words.empty() ){
+    return false;
+  }
+
+  unsigned int offset = 0;
+  for( unsigned int i = 0; i < llm->feature_set()->feature_products().size(); i++ ){
+    const Feature_Product * feature_product = llm->feature_set()->feature_products()[ i ];
+    // the weights are only indexed for products of a correspondence, a language and a grounding group
+    if( feature_product->feature_groups().size() == 3 ){
+      const vector< Feature* >& cv_features = feature_product->feature_groups()[ 0 ];
+      const vector< Feature* >& language_features = feature_product->feature_groups()[ 1 ];
+      const vector< Feature* >& grounding_features = feature_product->feature_groups()[ 2 ];
+      for( unsigned int j = 0; j < cv_features.size(); j++ ){
+        const Feature_CV * feature_cv = dynamic_cast< const Feature_CV* >( cv_features[ j ] );
+        if( ( feature_cv == NULL ) || ( feature_cv->invert() ) || ( feature_cv->cv() != CV_TRUE ) ){
+          continue;
+        }
+        for( unsigned int k = 0; k < language_features.size(); k++ ){
+          const Feature_Word * feature_word = dynamic_cast< const Feature_Word* >( language_features[ k ] );
+          if( ( feature_word == NULL ) || ( feature_word->invert() ) || ( find( words.begin(), words.end(), feature_word->word() ) == words.end() ) ){
+            continue;
+          }
+          for( unsigned int l = 0; l < grounding_features.size(); l++ ){
+            const Feature_Grounding_Property_Value * feature_property = dynamic_cast< const Feature_Grounding_Property_Value* >( grounding_features[ l ] );
+            if( ( feature_property == NULL ) || ( feature_property->invert() ) || ( feature_property->key() != "object_type" ) || ( feature_property->symbol() == "na" ) ){
+              continue;
+            }
+            unsigned int index = offset + j * language_features.size() * grounding_features.size() + k * grounding_features.size() + l;
+            if( ( index < llm->weights().size() ) && ( llm->weights()[ index ] > _threshold ) ){
+              if( find( objectTypes.begin(), objectTypes.end(), feature_property->symbol() ) == objectTypes.end() ){
+                objectTypes.push_back( feature_property->symbol() );
+              }
+            }
+          }
+        }
+      }
+    }
+    offset += feature_product->size();
+  }
+  return !objectTypes.empty();
+}
+
+void
+Lexical_Object_Filter::
+_scrape_words( const Phrase* phrase,
+                vector< Word >& words )const{
+  words.insert( words.end(), phrase->words().begin(), phrase->words().end() );
+  for( unsigned int i = 0; i < phrase->children().size(); i++ ){
+    _scrape_words( phrase->children()[ i ], words );
+  }
+  return;
+}
+
+namespace h2sl {
+  ostream&
+  operator<<( ostream& out,
+              const Lexical_Object_Filter& other ) {
+    out << "threshold:" << other.threshold();
+    return out;
+  }
+}
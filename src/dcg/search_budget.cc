@@ -0,0 +1,145 @@
+/**
+ * @file    search_budget.cc
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of a class used to bound the time spent searching a
+ *   Distributed Correspondence Graph
+ */
+
+#include "h2sl/common.h"
+#include "h2sl/search_budget.h"
+
+using namespace std;
+using namespace h2sl;
+
+Search_Budget::
+Search_Budget( const double& duration ) : _duration( duration ),
+                                          _start_time(),
+                                          _cancelled( false ),
+                                          _mutex() {
+  clock_gettime( CLOCK_MONOTONIC, &_start_time );
+}
+
+Search_Budget::
+~Search_Budget() {
+
+}
+
+Search_Budget::
+Search_Budget( const Search_Budget& other ) : _duration( other._duration ),
+                                              _start_time( other._start_time ),
+                                              _cancelled( other.cancelled() ),
+                                              _mutex() {
+
+}
+
+Search_Budget&
+Search_Budget::
+operator=( const Search_Budget& other ) {
+  bool cancelled = other.cancelled();
+  boost::mutex::scoped_lock lock( _mutex );
+  _duration = other._duration;
+  _start_time = other._start_time;
+  _cancelled = cancelled;
+  return (*this);
+}
+
+void
+Search_Budget::
+restart( void ){
+  boost::mutex::scoped_lock lock( _mutex );
+  clock_gettime( CLOCK_MONOTONIC, &_start_time );
+  _cancelled = false;
+  return;
+}
+
+void
+Search_Budget::
+cancel( void ){
+  boost::mutex::scoped_lock lock( _mutex );
+  _cancelled = true;
+  return;
+}
+
+bool
+Search_Budget::
+cancelled( void )const{
+  boost::mutex::scoped_lock lock( _mutex );
+  return _cancelled;
+}
+
+bool
+Search_Budget::
+expired( void )const{
+  if( cancelled() ){
+    return true;
+  } else if( _duration > 0.0 ){
+    return ( elapsed() >= _duration );
+  } else {
+    return false;
+  }
+}
+
+/**
+ * returns the time since construction or restart() on a monotonic clock, so 
+ *   changes to the system time do not move the deadline
+ */
+double
+Search_Budget::
+elapsed( void )const{
+  struct timespec current_time;
+  clock_gettime( CLOCK_MONOTONIC, &current_time );
+  boost::mutex::scoped_lock lock( _mutex );
+  return ( double )( current_time.tv_sec - _start_time.tv_sec ) + ( double )( current_time.tv_nsec - _start_time.tv_nsec ) / 1000000000.0;
+}
+
+/**
+ * returns the fraction of the duration that is left, one for budgets that never expire
+ */
+double
+Search_Budget::
+remaining_fraction( void )const{
+  if( cancelled() ){
+    return 0.0;
+  } else if( _duration > 0.0 ){
+    double remaining = 1.0 - elapsed() / _duration;
+    return ( remaining > 0.0 ) ? remaining : 0.0;
+  } else {
+    return 1.0;
+  }
+}
+
+namespace h2sl {
+  ostream&
+  operator<<( ostream& out,
+              const Search_Budget& other ) {
+    out << "duration:" << other.duration() << " elapsed:" << other.elapsed() << " cancelled:" << other.cancelled();
+    return out;
+  }
+}
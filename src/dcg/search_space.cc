@@ -0,0 +1,358 @@
+/**
+ * @file    search_space.cc
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of a class used to represent the search space of a
+ *   Distributed Correspondence Graph for a single world
+ */
+
+#include "h2sl/cv.h"
+#include "h2sl/search_space.h"
+
+using namespace std;
+using namespace h2sl;
+
+Search_Space::
+Search_Space() : _correspondence_variables(),
+                  _region_types(),
+                  _constraint_types(),
+                  _num_objects( 0 ),
+                  _regions(),
+                  _constraints(),
+                  _groundings(),
+                  _partitions(),
+                  _world_hash( 0 ),
+                  _feature_table() {
+
+}
+
+Search_Space::
+~Search_Space() {
+
+}
+
+Search_Space::
+Search_Space( const Search_Space& other ) : _correspondence_variables( other._correspondence_variables ),
+                                            _region_types( other._region_types ),
+                                            _constraint_types( other._constraint_types ),
+                                            _num_objects( other._num_objects ),
+                                            _regions( other._regions ),
+                                            _constraints( other._constraints ),
+                                            _groundings(),
+                                            _partitions(),
+                                            _world_hash( other._world_hash ),
+                                            _feature_table() {
+  _fill_groundings();
+}
+
+Search_Space&
+Search_Space::
+operator=( const Search_Space& other ) {
+  _correspondence_variables = other._correspondence_variables;
+  _region_types = other._region_types;
+  _constraint_types = other._constraint_types;
+  _num_objects = other._num_objects;
+  _regions = other._regions;
+  _constraints = other._constraints;
+  _world_hash = other._world_hash;
+  _feature_table.clear();
+  _fill_groundings();
+  return (*this);
+}
+
+void
+Search_Space::
+fill( const World* world ){
+  clear();
+
+  std::vector< unsigned int > binary_cvs;
+  binary_cvs.push_back( CV_FALSE );
+  binary_cvs.push_back( CV_TRUE );
+
+  std::vector< unsigned int > ternary_cvs;
+  ternary_cvs.push_back( CV_FALSE );
+  ternary_cvs.push_back( CV_TRUE );
+  ternary_cvs.push_back( CV_INVERTED );
+
+  _correspondence_variables.push_back( binary_cvs );
+  _correspondence_variables.push_back( ternary_cvs );
+
+  _region_types.push_back( "na" );
+  _region_types.push_back( "near" );
+  _region_types.push_back( "far" );
+  _region_types.push_back( "left" );
+  _region_types.push_back( "right" );
+  _region_types.push_back( "front" );
+  _region_types.push_back( "back" );
+  _region_types.push_back( "above" );
+  _region_types.push_back( "below" );
+
+  _constraint_types.push_back( "inside" );
+  _constraint_types.push_back( "outside" );
+
+  _num_objects = world->objects().size();
+  _regions.reserve( _num_objects + ( _region_types.size() - 1 ) * ( _num_objects + 1 ) );
+  _constraints.reserve( _constraint_types.size() * ( _num_objects * _region_types.size() * _num_objects * _region_types.size() - _num_objects * _region_types.size() ) );
+
+  // add the NP groundings; exhaustively fill the object symbol space (regions with unknown type and known object)
+  for( unsigned int i = 0; i < _num_objects; i++ ){
+    _regions.push_back( Region( "na", *world->objects()[ i ] ) );
+  }
+
+  // add the PP groundings; exhaustively fill the region symbol space (does no duplicate the above loop)
+  for( unsigned int i = 0; i < _region_types.size(); i++ ){
+    if( _region_types[ i ] != "na" ){
+      _regions.push_back( Region( _region_types[ i ], Object() ) );
+      for( unsigned int j = 0; j < _num_objects; j++ ){
+        _regions.push_back( Region( _region_types[ i ], *world->objects()[ j ] ) );
+      }
+    }
+  }
+
+  // add the VP groundings; exhaustively fill the constraint symbol space
+  for( unsigned int i = 0; i < _constraint_types.size(); i++ ){
+    for( unsigned int j = 0; j < _num_objects; j++ ){
+      for( unsigned int k = 0; k < _region_types.size(); k++ ){
+        for( unsigned int l = 0; l < _num_objects; l++ ){
+          for( unsigned int m = 0; m < _region_types.size(); m++ ){
+            if( ( j != l ) || ( k != m ) ){
+              _constraints.push_back( Constraint( _constraint_types[ i ], Region( _region_types[ k ], *world->objects()[ j ] ), Region( _region_types[ m ], *world->objects()[ l ] ) ) );
+            }
+          }
+        }
+      }
+    }
+  }
+
+  _world_hash = world->hash();
+  _fill_groundings();
+  return;
+}
+
+/**
+ * a constraint is canonical if its parent region precedes its child region; the 
+ *   other orientation of the pair is its mirror
+ */
+bool
+Search_Space::
+is_canonical( const unsigned int& index )const{
+  if( index < _regions.size() ){
+    return true;
+  }
+  unsigned int num_regions = _num_objects * _region_types.size();
+  unsigned int offset = ( index - _regions.size() ) % ( num_regions * num_regions - num_regions );
+  unsigned int parent = offset / ( num_regions - 1 );
+  unsigned int child = offset % ( num_regions - 1 );
+  if( child >= parent ){
+    child++;
+  }
+  return ( parent < child );
+}
+
+unsigned int
+Search_Space::
+mirror_index( const unsigned int& index )const{
+  if( index < _regions.size() ){
+    return index;
+  }
+  unsigned int num_regions = _num_objects * _region_types.size();
+  unsigned int constraint_type = ( index - _regions.size() ) / ( num_regions * num_regions - num_regions );
+  unsigned int offset = ( index - _regions.size() ) % ( num_regions * num_regions - num_regions );
+  unsigned int parent = offset / ( num_regions - 1 );
+  unsigned int child = offset % ( num_regions - 1 );
+  if( child >= parent ){
+    child++;
+  }
+  return constraint_index( constraint_type, child / _region_types.size(), child % _region_types.size(), parent / _region_types.size(), parent % _region_types.size() );
+}
+
+/**
+ * the mirror of a constraint in this search space, or NULL for any other grounding
+ */
+Grounding*
+Search_Space::
+mirror( const Grounding* grounding )const{
+  const Constraint * constraint = dynamic_cast< const Constraint* >( grounding );
+  if( ( constraint == NULL ) || _constraints.empty() || ( constraint < &_constraints.front() ) || ( constraint > &_constraints.back() ) ){
+    return NULL;
+  }
+  return _groundings[ mirror_index( _regions.size() + ( constraint - &_constraints.front() ) ) ].second;
+}
+
+/**
+ * updates the groundings of the changed objects in place, leaving the pointers valid; 
+ *   a world with added, removed or reordered objects is filled again and false is returned
+ */
+bool
+Search_Space::
+update( const World* world,
+        const World_Diff& diff ){
+  if( diff.changes_objects() || ( world->objects().size() != _num_objects ) ){
+    fill( world );
+    return false;
+  }
+
+  // the regions and constraints are indexed in the order of the world that filled them
+  for( unsigned int i = 0; i < _num_objects; i++ ){
+    if( world->objects()[ i ]->name() != _regions[ i ].object().name() ){
+      fill( world );
+      return false;
+    }
+  }
+
+  _feature_table.clear();
+  unsigned int num_region_types = _region_types.size();
+  for( unsigned int i = 0; i < diff.changed().size(); i++ ){
+    unsigned int object_index = 0;
+    while( ( object_index < _num_objects ) && ( _regions[ object_index ].object().name() != diff.changed()[ i ].name() ) ){
+      object_index++;
+    }
+    if( object_index == _num_objects ){
+      continue;
+    }
+    const Object& object = *world->objects()[ object_index ];
+
+    // the object's region of unknown type, then one region for each known type
+    _regions[ object_index ].object() = object;
+    for( unsigned int j = 1; j < num_region_types; j++ ){
+      _regions[ _num_objects + ( j - 1 ) * ( _num_objects + 1 ) + 1 + object_index ].object() = object;
+    }
+
+    // the constraints with the object's regions as parent or child
+    for( unsigned int j = 0; j < _constraint_types.size(); j++ ){
+      for( unsigned int k = 0; k < num_region_types; k++ ){
+        for( unsigned int l = 0; l < _num_objects; l++ ){
+          for( unsigned int m = 0; m < num_region_types; m++ ){
+            if( ( l != object_index ) || ( m != k ) ){
+              _constraints[ constraint_index( j, object_index, k, l, m ) - _regions.size() ].parent().object() = object;
+              _constraints[ constraint_index( j, l, m, object_index, k ) - _regions.size() ].child().object() = object;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  _world_hash = world->hash();
+  return true;
+}
+
+void
+Search_Space::
+clear( void ){
+  _correspondence_variables.clear();
+  _region_types.clear();
+  _constraint_types.clear();
+  _num_objects = 0;
+  _groundings.clear();
+  _partitions.clear();
+  _regions.clear();
+  _constraints.clear();
+  _world_hash = 0;
+  _feature_table.clear();
+  return;
+}
+
+/**
+ * finds the object and region type indices of a region over one of the world objects 
+ */
+bool
+Search_Space::
+region_indices( const Grounding* grounding,
+                unsigned int& objectIndex,
+                unsigned int& regionTypeIndex )const{
+  const Region * region = dynamic_cast< const Region* >( grounding );
+  if( region == NULL ){
+    return false;
+  }
+  for( regionTypeIndex = 0; regionTypeIndex < _region_types.size(); regionTypeIndex++ ){
+    if( _region_types[ regionTypeIndex ] == region->region_type() ){
+      break;
+    }
+  }
+  if( regionTypeIndex == _region_types.size() ){
+    return false;
+  }
+  // the first _num_objects regions hold the world objects in order
+  for( objectIndex = 0; objectIndex < _num_objects; objectIndex++ ){
+    if( _regions[ objectIndex ].object() == region->object() ){
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * returns the index in groundings() of a constraint; the parent and child regions must differ
+ */
+unsigned int
+Search_Space::
+constraint_index( const unsigned int& constraintTypeIndex,
+                  const unsigned int& parentObjectIndex,
+                  const unsigned int& parentRegionTypeIndex,
+                  const unsigned int& childObjectIndex,
+                  const unsigned int& childRegionTypeIndex )const{
+  unsigned int num_regions = _num_objects * _region_types.size();
+  unsigned int parent = parentObjectIndex * _region_types.size() + parentRegionTypeIndex;
+  unsigned int child = childObjectIndex * _region_types.size() + childRegionTypeIndex;
+  unsigned int index = constraintTypeIndex * ( num_regions * num_regions - num_regions ) + parent * num_regions + child - parent;
+  if( child > parent ){
+    index--;
+  }
+  return _regions.size() + index;
+}
+
+/**
+ * the regions use the binary correspondence variables and the constraints use the ternary ones
+ */
+void
+Search_Space::
+_fill_groundings( void ){
+  _groundings.clear();
+  _partitions.clear();
+  _groundings.reserve( _regions.size() + _constraints.size() );
+  for( unsigned int i = 0; i < _regions.size(); i++ ){
+    _groundings.push_back( pair< unsigned int, Grounding* >( 0, &_regions[ i ] ) );
+  }
+  _partitions.push_back( pair< string, pair< unsigned int, unsigned int > >( Region::class_name(), pair< unsigned int, unsigned int >( 0, _groundings.size() ) ) );
+  for( unsigned int i = 0; i < _constraints.size(); i++ ){
+    _groundings.push_back( pair< unsigned int, Grounding* >( 1, &_constraints[ i ] ) );
+  }
+  _partitions.push_back( pair< string, pair< unsigned int, unsigned int > >( Constraint::class_name(), pair< unsigned int, unsigned int >( _regions.size(), _groundings.size() ) ) );
+  return;
+}
+
+namespace h2sl {
+  ostream&
+  operator<<( ostream& out,
+              const Search_Space& other ) {
+    out << "regions[" << other.regions().size() << "] constraints[" << other.constraints().size() << "] world_hash:" << other.world_hash();
+    return out;
+  }
+}
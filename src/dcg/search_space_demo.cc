@@ -0,0 +1,76 @@
+/**
+ * @file    search_space_demo.cc
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * A Search_Space class demo program
+ */
+
+#include <iostream>
+#include "h2sl/world.h"
+#include "h2sl/search_space.h"
+#include "search_space_demo_cmdline.h"
+
+using namespace std;
+using namespace h2sl;
+
+int
+main( int argc,
+      char* argv[] ) {
+  int status = 0;
+  cout << "start of Search_Space class demo program" << endl;
+
+  gengetopt_args_info args;
+  if( cmdline_parser( argc, argv, &args ) != 0 ){
+    exit(1);
+  }
+
+  World * world = new World();
+  if( args.world_given ){
+    world->from_xml( args.world_arg );
+  }
+
+  Search_Space * search_space = new Search_Space();
+  search_space->fill( world );
+
+  cout << "search_space:" << *search_space << endl;
+  cout << "groundings.size(): " << search_space->groundings().size() << endl;
+
+  if( search_space != NULL ){
+    delete search_space;
+    search_space = NULL;
+  }
+
+  if( world != NULL ){
+    delete world;
+    world = NULL;
+  }
+
+  cout << "end of Search_Space class demo program" << endl;
+  return status;
+}
@@ -0,0 +1,226 @@
+/**
+ * @file    search_space_filter.cc
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of a class used to restrict the grounding classes 
+ *   that are searched for each phrase type
+ */
+
+#include <sstream>
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
+
+#include "h2sl/grounding_set.h"
+#include "h2sl/object.h"
+#include "h2sl/region.h"
+#include "h2sl/constraint.h"
+#include "h2sl/search_space_filter.h"
+
+using namespace std;
+using namespace h2sl;
+
+Search_Space_Filter::
+Search_Space_Filter() : _grounding_classes() {
+
+}
+
+Search_Space_Filter::
+~Search_Space_Filter() {
+
+}
+
+Search_Space_Filter::
+Search_Space_Filter( const Search_Space_Filter& other ) : _grounding_classes( other._grounding_classes ) {
+
+}
+
+Search_Space_Filter&
+Search_Space_Filter::
+operator=( const Search_Space_Filter& other ) {
+  _grounding_classes = other._grounding_classes;
+  return (*this);
+}
+
+/**
+ * records the classes of the annotated groundings of a phrase and its children
+ */
+void
+Search_Space_Filter::
+learn( const Phrase* phrase ){
+  vector< string >& grounding_classes = _grounding_classes[ phrase->type() ];
+  const Grounding_Set * grounding_set = dynamic_cast< const Grounding_Set* >( phrase->grounding() );
+  if( grounding_set != NULL ){
+    for( unsigned int i = 0; i < grounding_set->groundings().size(); i++ ){
+      string grounding_class = "na";
+      if( dynamic_cast< const Constraint* >( grounding_set->groundings()[ i ] ) != NULL ){
+        grounding_class = Constraint::class_name();
+      } else if( dynamic_cast< const Region* >( grounding_set->groundings()[ i ] ) != NULL ){
+        grounding_class = Region::class_name();
+      } else if( dynamic_cast< const Object* >( grounding_set->groundings()[ i ] ) != NULL ){
+        grounding_class = Object::class_name();
+      }
+      if( find( grounding_classes.begin(), grounding_classes.end(), grounding_class ) == grounding_classes.end() ){
+        grounding_classes.push_back( grounding_class );
+      }
+    }
+  }
+  for( unsigned int i = 0; i < phrase->children().size(); i++ ){
+    learn( phrase->children()[ i ] );
+  }
+  return;
+}
+
+bool
+Search_Space_Filter::
+has_phrase_type( const phrase_type_t& phraseType )const{
+  return ( _grounding_classes.find( phraseType ) != _grounding_classes.end() );
+}
+
+bool
+Search_Space_Filter::
+allows( const phrase_type_t& phraseType,
+        const string& groundingClass )const{
+  map< phrase_type_t, vector< string > >::const_iterator it = _grounding_classes.find( phraseType );
+  if( it == _grounding_classes.end() ){
+    return true;
+  } else {
+    return ( find( it->second.begin(), it->second.end(), groundingClass ) != it->second.end() );
+  }
+}
+
+void
+Search_Space_Filter::
+clear( void ){
+  _grounding_classes.clear();
+  return;
+}
+
+void
+Search_Space_Filter::
+to_xml( const string& filename )const{
+  xmlDocPtr doc = xmlNewDoc( ( xmlChar* )( "1.0" ) );
+  xmlNodePtr root = xmlNewDocNode( doc, NULL, ( xmlChar* )( "root" ), NULL );
+  xmlDocSetRootElement( doc, root );
+  to_xml( doc, root );
+  xmlSaveFormatFileEnc( filename.c_str(), doc, "UTF-8", 1 );
+  xmlFreeDoc( doc );
+  return;
+}
+
+void
+Search_Space_Filter::
+to_xml( xmlDocPtr doc,
+        xmlNodePtr root )const{
+  xmlNodePtr node = xmlNewDocNode( doc, NULL, ( const xmlChar* )( "search_space_filter" ), NULL );
+  for( map< phrase_type_t, vector< string > >::const_iterator it = _grounding_classes.begin(); it != _grounding_classes.end(); it++ ){
+    xmlNodePtr phrase_node = xmlNewDocNode( doc, NULL, ( const xmlChar* )( "phrase" ), NULL );
+    xmlNewProp( phrase_node, ( const xmlChar* )( "type" ), ( const xmlChar* )( Phrase::phrase_type_t_to_std_string( it->first ).c_str() ) );
+    stringstream grounding_classes_string;
+    for( unsigned int i = 0; i < it->second.size(); i++ ){
+      grounding_classes_string << it->second[ i ];
+      if( i != ( it->second.size() - 1 ) ){
+        grounding_classes_string << ",";
+      }
+    }
+    xmlNewProp( phrase_node, ( const xmlChar* )( "grounding_classes" ), ( const xmlChar* )( grounding_classes_string.str().c_str() ) );
+    xmlAddChild( node, phrase_node );
+  }
+  xmlAddChild( root, node );
+  return;
+}
+
+void
+Search_Space_Filter::
+from_xml( const string& filename ){
+  xmlDoc * doc = NULL;
+  xmlNodePtr root = NULL;
+  doc = xmlReadFile( filename.c_str(), NULL, 0 );
+  if( doc != NULL ){
+    root = xmlDocGetRootElement( doc );
+    if( root->type == XML_ELEMENT_NODE ){
+      xmlNodePtr l1 = NULL;
+      for( l1 = root->children; l1; l1 = l1->next ){
+        if( l1->type == XML_ELEMENT_NODE ){
+          if( xmlStrcmp( l1->name, ( const xmlChar* )( "search_space_filter" ) ) == 0 ){
+            from_xml( l1 );
+          }
+        }
+      }
+    }
+    xmlFreeDoc( doc );
+  }
+  return;
+}
+
+void
+Search_Space_Filter::
+from_xml( xmlNodePtr root ){
+  clear();
+  if( root->type == XML_ELEMENT_NODE ){
+    xmlNodePtr l1 = NULL;
+    for( l1 = root->children; l1; l1 = l1->next ){
+      if( l1->type == XML_ELEMENT_NODE ){
+        if( xmlStrcmp( l1->name, ( const xmlChar* )( "phrase" ) ) == 0 ){
+          xmlChar * tmp = xmlGetProp( l1, ( const xmlChar* )( "type" ) );
+          if( tmp != NULL ){
+            vector< string >& grounding_classes = _grounding_classes[ Phrase::phrase_type_t_from_std_string( ( char* )( tmp ) ) ];
+            xmlFree( tmp );
+            tmp = xmlGetProp( l1, ( const xmlChar* )( "grounding_classes" ) );
+            if( tmp != NULL ){
+              string grounding_classes_string = ( char* )( tmp );
+              if( !grounding_classes_string.empty() ){
+                boost::split( grounding_classes, grounding_classes_string, boost::is_any_of( "," ) );
+              }
+              xmlFree( tmp );
+            }
+          }
+        }
+      }
+    }
+  }
+  return;
+}
+
+namespace h2sl {
+  ostream&
+  operator<<( ostream& out,
+              const Search_Space_Filter& other ) {
+    for( map< phrase_type_t, vector< string > >::const_iterator it = other.grounding_classes().begin(); it != other.grounding_classes().end(); it++ ){
+      out << Phrase::phrase_type_t_to_std_string( it->first ) << ":{";
+      for( unsigned int i = 0; i < it->second.size(); i++ ){
+        out << it->second[ i ];
+        if( i != ( it->second.size() - 1 ) ){
+          out << ",";
+        }
+      }
+      out << "} ";
+    }
+    return out;
+  }
+}
@@ -0,0 +1,160 @@
+/**
+ * @file    solution_cache.cc
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of a class used to cache the solutions of grounded
+ *   subtrees across queries
+ */
+
+#include "h2sl/solution_cache.h"
+
+using namespace std;
+using namespace h2sl;
+
+Solution_Cache::
+Solution_Cache( const unsigned int& size ) : _size( size ),
+                                              _entries(),
+                                              _index(),
+                                              _num_hits( 0 ),
+                                              _num_misses( 0 ) {
+
+}
+
+Solution_Cache::
+~Solution_Cache() {
+
+}
+
+Solution_Cache::
+Solution_Cache( const Solution_Cache& other ) : _size( other._size ),
+                                                _entries( other._entries ),
+                                                _index(),
+                                                _num_hits( other._num_hits ),
+                                                _num_misses( other._num_misses ) {
+  for( list< Solution_Cache_Entry >::iterator it = _entries.begin(); it != _entries.end(); it++ ){
+    _index[ it->key ] = it;
+  }
+}
+
+Solution_Cache&
+Solution_Cache::
+operator=( const Solution_Cache& other ) {
+  _size = other._size;
+  _entries = other._entries;
+  _index.clear();
+  for( list< Solution_Cache_Entry >::iterator it = _entries.begin(); it != _entries.end(); it++ ){
+    _index[ it->key ] = it;
+  }
+  _num_hits = other._num_hits;
+  _num_misses = other._num_misses;
+  return (*this);
+}
+
+/**
+ * returns the cached solutions if they were searched with the same beam width and 
+ *   no higher threshold, otherwise NULL
+ */
+const Factor_Set_Subtree_Solutions*
+Solution_Cache::
+find( const size_t& key,
+      const size_t& queryKey,
+      const string& subtree,
+      const unsigned int& beamWidth,
+      const double& threshold ){
+  map< size_t, list< Solution_Cache_Entry >::iterator >::iterator it = _index.find( key );
+  if( ( it != _index.end() ) && ( it->second->query_key == queryKey ) && ( it->second->subtree_solutions.subtree == subtree ) && ( it->second->subtree_solutions.beam_width == beamWidth ) && ( it->second->subtree_solutions.threshold <= threshold ) ){
+    _entries.splice( _entries.begin(), _entries, it->second );
+    _num_hits++;
+    return &( _entries.front().subtree_solutions );
+  } else {
+    _num_misses++;
+    return NULL;
+  }
+}
+
+void
+Solution_Cache::
+insert( const size_t& key,
+        const size_t& queryKey,
+        const size_t& worldHash,
+        const Factor_Set_Subtree_Solutions& subtreeSolutions ){
+  if( _size == 0 ){
+    return;
+  }
+
+  map< size_t, list< Solution_Cache_Entry >::iterator >::iterator it = _index.find( key );
+  if( it != _index.end() ){
+    _entries.erase( it->second );
+    _index.erase( it );
+  }
+
+  _entries.push_front( Solution_Cache_Entry( key, queryKey, worldHash, subtreeSolutions ) );
+  _index[ key ] = _entries.begin();
+
+  while( _entries.size() > _size ){
+    _index.erase( _entries.back().key );
+    _entries.pop_back();
+  }
+  return;
+}
+
+/**
+ * removes the entries whose groundings point into the search space of a world
+ */
+void
+Solution_Cache::
+erase_world( const size_t& worldHash ){
+  list< Solution_Cache_Entry >::iterator it = _entries.begin();
+  while( it != _entries.end() ){
+    if( it->world_hash == worldHash ){
+      _index.erase( it->key );
+      it = _entries.erase( it );
+    } else {
+      it++;
+    }
+  }
+  return;
+}
+
+void
+Solution_Cache::
+clear( void ){
+  _entries.clear();
+  _index.clear();
+  return;
+}
+
+namespace h2sl {
+  ostream&
+  operator<<( ostream& out,
+              const Solution_Cache& other ) {
+    out << "size:" << other.entries().size() << "/" << other.size() << " hits:" << other.num_hits() << " misses:" << other.num_misses();
+    return out;
+  }
+}
@@ -78,6 +78,7 @@ namespace h2sl {
     bool has_word( const Word& word )const;
     bool has_words( const std::vector< Word >& words )const;
     unsigned int min_word_order( void )const;
+    std::size_t hash( void )const;
     
     std::string words_to_std_string( void )const;
 
@@ -34,6 +34,7 @@
 #include <assert.h>
 #include <fstream>
 #include <sstream>
+#include <boost/functional/hash.hpp>
 
 #include <h2sl/phrase.h>
 #include <h2sl/grounding_set.h>
@@ -274,6 +275,27 @@ has_words( const vector< Word >& words )const{
   return true;
 }
 
+/**
+ * hashes the structure of the phrase (type, words and children); the word order and 
+ *   grounding are not included
+ */
+size_t
+Phrase::
+hash( void )const{
+  size_t seed = _type;
+  for( unsigned int i = 0; i < _words.size(); i++ ){
+    boost::hash_combine( seed, _words[ i ].pos() );
+    boost::hash_combine( seed, _words[ i ].text() );
+  }
+  boost::hash_combine( seed, _children.size() );
+  for( unsigned int i = 0; i < _children.size(); i++ ){
+    if( _children[ i ] != NULL ){
+      boost::hash_combine( seed, _children[ i ]->hash() );
+    }
+  }
+  return seed;
+}
+
 unsigned int
 Phrase::
 min_word_order( void )const{
@@ -0,0 +1,342 @@
+/**
+ * @file    constraint_scorer.cc
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of a class used to score constraints from partial sums 
+ *   over the features of their parent and child regions
+ */
+
+#include <cmath>
+
+#include "h2sl/constraint_scorer.h"
+
+using namespace std;
+using namespace h2sl;
+
+Constraint_Scorer::
+Constraint_Scorer() : _llm( NULL ),
+                      _cvs(),
+                      _grounding_groups(),
+                      _weights(),
+                      _parent_scores(),
+                      _child_scores(),
+                      _prepared( false ) {
+
+}
+
+Constraint_Scorer::
+~Constraint_Scorer() {
+
+}
+
+Constraint_Scorer::
+Constraint_Scorer( const Constraint_Scorer& other ) : _llm( other._llm ),
+                                                      _cvs( other._cvs ),
+                                                      _grounding_groups( other._grounding_groups ),
+                                                      _weights( other._weights ),
+                                                      _parent_scores( other._parent_scores ),
+                                                      _child_scores( other._child_scores ),
+                                                      _prepared( other._prepared ) {
+
+}
+
+Constraint_Scorer&
+Constraint_Scorer::
+operator=( const Constraint_Scorer& other ) {
+  _llm = other._llm;
+  _cvs = other._cvs;
+  _grounding_groups = other._grounding_groups;
+  _weights = other._weights;
+  _parent_scores = other._parent_scores;
+  _child_scores = other._child_scores;
+  _prepared = other._prepared;
+  return (*this);
+}
+
+/**
+ * sums the weights of the active correspondence and language features for each 
+ *   grounding feature; returns false if a feature product is not linear in a 
+ *   single group of grounding features
+ */
+bool
+Constraint_Scorer::
+prepare( LLM* llm,
+          const Phrase* phrase,
+          const World* world,
+          const Grounding* context,
+          const vector< unsigned int >& cvs ){
+  clear();
+  _llm = llm;
+  _cvs = cvs;
+
+  const vector< Feature_Product* >& feature_products = llm->feature_set()->feature_products();
+  vector< pair< const Phrase*, vector< Grounding* > > > children;
+  _grounding_groups.resize( feature_products.size() );
+  _weights.resize( feature_products.size() );
+  unsigned int offset = 0;
+  for( unsigned int i = 0; i < feature_products.size(); i++ ){
+    const vector< vector< Feature* > >& feature_groups = feature_products[ i ]->feature_groups();
+    // Feature_Product::indices() only scores products of three groups
+    _grounding_groups[ i ] = feature_groups.size();
+    if( feature_groups.size() == 3 ){
+      for( unsigned int j = 0; j < feature_groups.size(); j++ ){
+        unsigned int num_grounding_features = 0;
+        for( unsigned int k = 0; k < feature_groups[ j ].size(); k++ ){
+          if( feature_groups[ j ][ k ]->type() == FEATURE_TYPE_GROUNDING ){
+            num_grounding_features++;
+          }
+        }
+        if( num_grounding_features == 0 ){
+          continue;
+        } else if( ( num_grounding_features < feature_groups[ j ].size() ) || ( _grounding_groups[ i ] != feature_groups.size() ) ){
+          clear();
+          return false;
+        }
+        _grounding_groups[ i ] = j;
+      }
+      if( _grounding_groups[ i ] == feature_groups.size() ){
+        clear();
+        return false;
+      }
+
+      _weights[ i ].resize( cvs.size(), vector< double >( feature_groups[ _grounding_groups[ i ] ].size(), 0.0 ) );
+      for( unsigned int j = 0; j < cvs.size(); j++ ){
+        vector< vector< unsigned int > > group_indices( feature_groups.size() );
+        for( unsigned int k = 0; k < feature_groups.size(); k++ ){
+          if( k != _grounding_groups[ i ] ){
+            for( unsigned int l = 0; l < feature_groups[ k ].size(); l++ ){
+              if( feature_groups[ k ][ l ]->value( cvs[ j ], NULL, children, phrase, world, context ) ){
+                group_indices[ k ].push_back( l );
+              }
+            }
+          } else {
+            for( unsigned int l = 0; l < feature_groups[ k ].size(); l++ ){
+              group_indices[ k ].push_back( l );
+            }
+          }
+        }
+        for( unsigned int k = 0; k < group_indices[ 0 ].size(); k++ ){
+          for( unsigned int l = 0; l < group_indices[ 1 ].size(); l++ ){
+            for( unsigned int m = 0; m < group_indices[ 2 ].size(); m++ ){
+              unsigned int index = group_indices[ 0 ][ k ] * feature_groups[ 1 ].size() * feature_groups[ 2 ].size() + group_indices[ 1 ][ l ] * feature_groups[ 2 ].size() + group_indices[ 2 ][ m ];
+              unsigned int grounding_index = ( _grounding_groups[ i ] == 0 ) ? group_indices[ 0 ][ k ] : ( ( _grounding_groups[ i ] == 1 ) ? group_indices[ 1 ][ l ] : group_indices[ 2 ][ m ] );
+              _weights[ i ][ j ][ grounding_index ] += llm->weights()[ offset + index ];
+            }
+          }
+        }
+      }
+    }
+    offset += feature_products[ i ]->size();
+  }
+  _prepared = true;
+  return true;
+}
+
+/**
+ * sums the weights of the features that depend on only the parent or the child 
+ *   region of a constraint, once for each region
+ */
+void
+Constraint_Scorer::
+fill_regions( const vector< const Region* >& regions,
+              const vector< pair< const Phrase*, vector< Grounding* > > >& children,
+              const Phrase* phrase,
+              const World* world,
+              const Grounding* context ){
+  _parent_scores.assign( regions.size(), vector< double >( _cvs.size(), 0.0 ) );
+  _child_scores.assign( regions.size(), vector< double >( _cvs.size(), 0.0 ) );
+  const vector< Feature_Product* >& feature_products = _llm->feature_set()->feature_products();
+  for( unsigned int i = 0; i < feature_products.size(); i++ ){
+    if( _grounding_groups[ i ] == feature_products[ i ]->feature_groups().size() ){
+      continue;
+    }
+    const vector< Feature* >& features = feature_products[ i ]->feature_groups()[ _grounding_groups[ i ] ];
+    for( unsigned int j = 0; j < features.size(); j++ ){
+      if( features[ j ]->constraint_region() == FEATURE_CONSTRAINT_REGION_NONE ){
+        continue;
+      }
+      vector< vector< double > >& scores = ( features[ j ]->constraint_region() == FEATURE_CONSTRAINT_REGION_PARENT ) ? _parent_scores : _child_scores;
+      for( unsigned int k = 0; k < regions.size(); k++ ){
+        if( features[ j ]->region_value( _cvs.front(), regions[ k ], children, phrase, world, context ) ){
+          for( unsigned int l = 0; l < _cvs.size(); l++ ){
+            scores[ k ][ l ] += _weights[ i ][ l ][ j ];
+          }
+        }
+      }
+    }
+  }
+  return;
+}
+
+/**
+ * evaluates the probability of every correspondence variable for a constraint 
+ *   from the partial sums of its regions and the remaining features
+ */
+void
+Constraint_Scorer::
+pygx( const Grounding* grounding,
+      const unsigned int& parentIndex,
+      const unsigned int& childIndex,
+      const vector< pair< const Phrase*, vector< Grounding* > > >& children,
+      const Phrase* phrase,
+      const World* world,
+      const Grounding* context,
+      const vector< vector< bool > >* groundingValues,
+      vector< double >& pygxs ){
+  pygxs.resize( _cvs.size() );
+  for( unsigned int i = 0; i < _cvs.size(); i++ ){
+    pygxs[ i ] = _parent_scores[ parentIndex ][ i ] + _child_scores[ childIndex ][ i ];
+  }
+
+  const vector< Feature_Product* >& feature_products = _llm->feature_set()->feature_products();
+  for( unsigned int i = 0; i < feature_products.size(); i++ ){
+    if( _grounding_groups[ i ] == feature_products[ i ]->feature_groups().size() ){
+      continue;
+    }
+    const vector< Feature* >& features = feature_products[ i ]->feature_groups()[ _grounding_groups[ i ] ];
+    unsigned int grounding_value_index = 0;
+    for( unsigned int j = 0; j < features.size(); j++ ){
+      bool value = false;
+      if( ( groundingValues != NULL ) && ( features[ j ]->grounding_only() ) ){
+        value = ( *groundingValues )[ i ][ grounding_value_index ];
+        grounding_value_index++;
+      } else if( features[ j ]->constraint_region() == FEATURE_CONSTRAINT_REGION_NONE ){
+        value = features[ j ]->value( _cvs.front(), grounding, children, phrase, world, context );
+      }
+      if( value && ( features[ j ]->constraint_region() == FEATURE_CONSTRAINT_REGION_NONE ) ){
+        for( unsigned int k = 0; k < _cvs.size(); k++ ){
+          pygxs[ k ] += _weights[ i ][ k ][ j ];
+        }
+      }
+    }
+  }
+
+  double denominator = 0.0;
+  for( unsigned int i = 0; i < _cvs.size(); i++ ){
+    pygxs[ i ] = exp( pygxs[ i ] );
+    denominator += pygxs[ i ];
+  }
+  for( unsigned int i = 0; i < _cvs.size(); i++ ){
+    pygxs[ i ] /= denominator;
+  }
+  return;
+}
+
+/**
+ * evaluates a constraint and its mirror, the same constraint with the roles of its 
+ *   regions swapped; both differ only in their regions, so the grounding-only features 
+ *   that do not look at a region are evaluated once for the pair
+ */
+void
+Constraint_Scorer::
+pygx( const Grounding* grounding,
+      const Grounding* mirror,
+      const unsigned int& parentIndex,
+      const unsigned int& childIndex,
+      const vector< pair< const Phrase*, vector< Grounding* > > >& children,
+      const Phrase* phrase,
+      const World* world,
+      const Grounding* context,
+      const vector< vector< bool > >* groundingValues,
+      vector< double >& pygxs,
+      vector< double >& mirrorPygxs ){
+  pygxs.resize( _cvs.size() );
+  mirrorPygxs.resize( _cvs.size() );
+  for( unsigned int i = 0; i < _cvs.size(); i++ ){
+    pygxs[ i ] = _parent_scores[ parentIndex ][ i ] + _child_scores[ childIndex ][ i ];
+    mirrorPygxs[ i ] = _parent_scores[ childIndex ][ i ] + _child_scores[ parentIndex ][ i ];
+  }
+
+  const vector< Feature_Product* >& feature_products = _llm->feature_set()->feature_products();
+  for( unsigned int i = 0; i < feature_products.size(); i++ ){
+    if( _grounding_groups[ i ] == feature_products[ i ]->feature_groups().size() ){
+      continue;
+    }
+    const vector< Feature* >& features = feature_products[ i ]->feature_groups()[ _grounding_groups[ i ] ];
+    unsigned int grounding_value_index = 0;
+    for( unsigned int j = 0; j < features.size(); j++ ){
+      bool value = false;
+      bool mirror_value = false;
+      if( ( groundingValues != NULL ) && ( features[ j ]->grounding_only() ) ){
+        value = ( *groundingValues )[ i ][ grounding_value_index ];
+        mirror_value = value;
+        grounding_value_index++;
+      } else if( features[ j ]->constraint_region() == FEATURE_CONSTRAINT_REGION_NONE ){
+        value = features[ j ]->value( _cvs.front(), grounding, children, phrase, world, context );
+        mirror_value = features[ j ]->grounding_only() ? value : features[ j ]->value( _cvs.front(), mirror, children, phrase, world, context );
+      }
+      if( features[ j ]->constraint_region() == FEATURE_CONSTRAINT_REGION_NONE ){
+        for( unsigned int k = 0; k < _cvs.size(); k++ ){
+          if( value ){
+            pygxs[ k ] += _weights[ i ][ k ][ j ];
+          }
+          if( mirror_value ){
+            mirrorPygxs[ k ] += _weights[ i ][ k ][ j ];
+          }
+        }
+      }
+    }
+  }
+
+  double denominator = 0.0;
+  double mirror_denominator = 0.0;
+  for( unsigned int i = 0; i < _cvs.size(); i++ ){
+    pygxs[ i ] = exp( pygxs[ i ] );
+    mirrorPygxs[ i ] = exp( mirrorPygxs[ i ] );
+    denominator += pygxs[ i ];
+    mirror_denominator += mirrorPygxs[ i ];
+  }
+  for( unsigned int i = 0; i < _cvs.size(); i++ ){
+    pygxs[ i ] /= denominator;
+    mirrorPygxs[ i ] /= mirror_denominator;
+  }
+  return;
+}
+
+void
+Constraint_Scorer::
+clear( void ){
+  _llm = NULL;
+  _cvs.clear();
+  _grounding_groups.clear();
+  _weights.clear();
+  _parent_scores.clear();
+  _child_scores.clear();
+  _prepared = false;
+  return;
+}
+
+namespace h2sl {
+  ostream&
+  operator<<( ostream& out,
+              const Constraint_Scorer& other ) {
+    out << "prepared:" << other.prepared() << " cvs[" << other.cvs().size() << "] regions:" << other.parent_scores().size();
+    return out;
+  }
+}
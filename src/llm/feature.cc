@@ -88,6 +88,21 @@ value( const unsigned int& cv,
   return value( cv, grounding, children, phrase, world );
 }
 
+/**
+ * the value of a constraint feature that depends on only one of its regions, 
+ *   evaluated on that region; see constraint_region()
+ */
+bool
+Feature::
+region_value( const unsigned int& cv,
+              const Region* region,
+              const std::vector< std::pair< const Phrase*, std::vector< Grounding* > > >& children,
+              const Phrase* phrase,
+              const World* world,
+              const Grounding* context ){
+  return false;
+}
+
 namespace h2sl {
   ostream&
   operator<<( ostream& out,
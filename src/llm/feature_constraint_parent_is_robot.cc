@@ -82,15 +82,26 @@ value( const unsigned int& cv,
         const Grounding* context ){
   const Constraint * constraint = dynamic_cast< const Constraint* >( grounding );
   if( constraint != NULL ){
-    if( ( constraint->parent().region_type() == "na" ) && ( constraint->parent().object().object_type() == "robot" ) ){
-      return !_invert;
-    } else {
-      return _invert;
-    }
+    return region_value( cv, &constraint->parent(), children, phrase, world, context );
   }
   return false;
 }
 
+bool
+Feature_Constraint_Parent_Is_Robot::
+region_value( const unsigned int& cv,
+              const Region* region,
+              const vector< pair< const Phrase*, vector< Grounding* > > >& children,
+              const Phrase* phrase,
+              const World* world,
+              const Grounding* context ){
+  if( ( region->region_type() == "na" ) && ( region->object().object_type() == "robot" ) ){
+    return !_invert;
+  } else {
+    return _invert;
+  }
+}
+
 void
 Feature_Constraint_Parent_Is_Robot::
 to_xml( xmlDocPtr doc, xmlNodePtr root )const{
@@ -82,19 +82,30 @@ value( const unsigned int& cv,
         const Grounding* context ){
   const Constraint * constraint = dynamic_cast< const Constraint* >( grounding );
   if( constraint != NULL ){
-    for( unsigned int i = 0; i < children.size(); i++ ){
-      for( unsigned int j = 0; j < children[ i ].second.size(); j++ ){
-        const Region * child = dynamic_cast< const Region* >( children[ i ].second[ j ] );
-        if( child != NULL ){
-          if( constraint->parent() == *child ){
-            return !_invert;
-          }
+    return region_value( cv, &constraint->parent(), children, phrase, world, context );
+  }
+  return false;
+}
+
+bool
+Feature_Constraint_Parent_Matches_Child_Region::
+region_value( const unsigned int& cv,
+              const Region* region,
+              const vector< pair< const Phrase*, vector< Grounding* > > >& children,
+              const Phrase* phrase,
+              const World* world,
+              const Grounding* context ){
+  for( unsigned int i = 0; i < children.size(); i++ ){
+    for( unsigned int j = 0; j < children[ i ].second.size(); j++ ){
+      const Region * child = dynamic_cast< const Region* >( children[ i ].second[ j ] );
+      if( child != NULL ){
+        if( *region == *child ){
+          return !_invert;
         }
-      }   
+      }
     }
-    return _invert;
   }
-  return false;
+  return _invert;
 }
 
 void
@@ -36,6 +36,7 @@
 #include "h2sl/object.h"
 #include "h2sl/region.h"
 #include "h2sl/constraint.h"
+#include "h2sl/cv.h"
 
 #include "h2sl/feature_word.h"
 #include "h2sl/feature_num_words.h"
@@ -90,9 +91,10 @@ indices( const unsigned int& cv,
           const Grounding* context,
           vector< unsigned int >& indices,
           vector< Feature* >& features,
-          const vector< bool >& evaluateFeatureTypes ){
+          const vector< bool >& evaluateFeatureTypes,
+          const vector< bool >* groundingValues ){
   indices.clear();
-  evaluate( cv, grounding, children, phrase, world, context, evaluateFeatureTypes );
+  evaluate( cv, grounding, children, phrase, world, context, evaluateFeatureTypes, groundingValues );
 
   std::vector< std::vector< unsigned int > > group_indices( _values.size() );
   for( unsigned int i = 0; i < _values.size(); i++ ){
@@ -165,13 +167,21 @@ evaluate( const unsigned int& cv,
           const Phrase* phrase,
           const World* world,
           const Grounding* context,
-          const vector< bool >& evaluateFeatureTypes ){
+          const vector< bool >& evaluateFeatureTypes,
+          const vector< bool >* groundingValues ){
 
 //  cout << "phrase:" << *phrase << endl;
 
+  // the grounding-only features are read from the precomputed values when they are given
+  unsigned int grounding_value_index = 0;
   for( unsigned int i = 0; i < _feature_groups.size(); i++ ){
     for( unsigned int j = 0; j < _feature_groups[ i ].size(); j++ ){
-      if( evaluateFeatureTypes[ _feature_groups[ i ][ j ]->type() ] ){
+      if( ( groundingValues != NULL ) && ( _feature_groups[ i ][ j ]->grounding_only() ) ){
+        if( evaluateFeatureTypes[ _feature_groups[ i ][ j ]->type() ] ){
+          _values[ i ][ j ] = ( *groundingValues )[ grounding_value_index ];
+        }
+        grounding_value_index++;
+      } else if( evaluateFeatureTypes[ _feature_groups[ i ][ j ]->type() ] ){
         _values[ i ][ j ] = _feature_groups[ i ][ j ]->value( cv, grounding, children, phrase, world, context );
       }
     }
@@ -189,6 +199,27 @@ evaluate( const unsigned int& cv,
   return;
 }
 
+/**
+ * evaluates the features that depend only on the grounding, in the order that 
+ *   evaluate() reads them
+ */
+void
+Feature_Product::
+grounding_values( const Grounding* grounding,
+                  const World* world,
+                  vector< bool >& groundingValues ){
+  groundingValues.clear();
+  vector< pair< const Phrase*, vector< Grounding* > > > children;
+  for( unsigned int i = 0; i < _feature_groups.size(); i++ ){
+    for( unsigned int j = 0; j < _feature_groups[ i ].size(); j++ ){
+      if( _feature_groups[ i ][ j ]->grounding_only() ){
+        groundingValues.push_back( _feature_groups[ i ][ j ]->value( CV_UNKNOWN, grounding, children, NULL, world, NULL ) );
+      }
+    }
+  }
+  return;
+}
+
 void 
 Feature_Product::
 to_xml( const string& filename )const{
@@ -79,12 +79,13 @@ indices( const unsigned int& cv,
           const Grounding* context,
           vector< unsigned int >& indices,
           vector< Feature* >& features,
-          const vector< bool >& evaluateFeatureTypes ){
+          const vector< bool >& evaluateFeatureTypes,
+          const vector< vector< bool > >* groundingValues ){
   indices.clear();
   unsigned int offset = 0;
   for( unsigned int i = 0; i < _feature_products.size(); i++ ){
     vector< unsigned int > product_indices;
-    _feature_products[ i ]->indices( cv, grounding, children, phrase, world, context, product_indices, features, evaluateFeatureTypes );
+    _feature_products[ i ]->indices( cv, grounding, children, phrase, world, context, product_indices, features, evaluateFeatureTypes, ( groundingValues != NULL ) ? &( *groundingValues )[ i ] : NULL );
     for( unsigned int j = 0; j < product_indices.size(); j++ ){
       indices.push_back( product_indices[ j ] + offset );
     }
@@ -125,10 +126,26 @@ evaluate( const unsigned int& cv,
           const Phrase* phrase,
           const World* world,
           const Grounding* context,
-          const vector< bool >& evaluateFeatureTypes ){
+          const vector< bool >& evaluateFeatureTypes,
+          const vector< vector< bool > >* groundingValues ){
 
   for( unsigned int i = 0; i < _feature_products.size(); i++ ){
-    _feature_products[ i ]->evaluate( cv, grounding, children, phrase, world, context, evaluateFeatureTypes );
+    _feature_products[ i ]->evaluate( cv, grounding, children, phrase, world, context, evaluateFeatureTypes, ( groundingValues != NULL ) ? &( *groundingValues )[ i ] : NULL );
+  }
+  return;
+}
+
+/**
+ * evaluates the grounding-only features of every feature product
+ */
+void
+Feature_Set::
+grounding_values( const Grounding* grounding,
+                  const World* world,
+                  vector< vector< bool > >& groundingValues ){
+  groundingValues.resize( _feature_products.size() );
+  for( unsigned int i = 0; i < _feature_products.size(); i++ ){
+    _feature_products[ i ]->grounding_values( grounding, world, groundingValues[ i ] );
   }
   return;
 }
@@ -0,0 +1,150 @@
+/**
+ * @file    feature_table.cc
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of a class used to store the values of the 
+ *   grounding-only features for the groundings of a search space
+ */
+
+#include "h2sl/constraint.h"
+#include "h2sl/feature_table.h"
+
+using namespace std;
+using namespace h2sl;
+
+Feature_Table::
+Feature_Table() : _feature_set( NULL ),
+                  _values(),
+                  _regions(),
+                  _constraint_regions() {
+
+}
+
+Feature_Table::
+~Feature_Table() {
+
+}
+
+Feature_Table::
+Feature_Table( const Feature_Table& other ) : _feature_set( other._feature_set ),
+                                              _values( other._values ),
+                                              _regions( other._regions ),
+                                              _constraint_regions( other._constraint_regions ) {
+
+}
+
+Feature_Table&
+Feature_Table::
+operator=( const Feature_Table& other ) {
+  _feature_set = other._feature_set;
+  _values = other._values;
+  _regions = other._regions;
+  _constraint_regions = other._constraint_regions;
+  return (*this);
+}
+
+/**
+ * evaluates the grounding-only features of the feature set for every grounding 
+ *   and indexes the regions of the constraints by content
+ */
+void
+Feature_Table::
+fill( Feature_Set* featureSet,
+      const vector< pair< unsigned int, Grounding* > >& groundings,
+      const World* world ){
+  clear();
+  _feature_set = featureSet;
+  map< size_t, unsigned int > region_indices;
+  for( unsigned int i = 0; i < groundings.size(); i++ ){
+    featureSet->grounding_values( groundings[ i ].second, world, _values[ groundings[ i ].second ] );
+    const Constraint * constraint = dynamic_cast< const Constraint* >( groundings[ i ].second );
+    if( constraint != NULL ){
+      pair< map< size_t, unsigned int >::iterator, bool > parent = region_indices.insert( pair< size_t, unsigned int >( constraint->parent().hash(), _regions.size() ) );
+      if( parent.second ){
+        _regions.push_back( &constraint->parent() );
+      }
+      pair< map< size_t, unsigned int >::iterator, bool > child = region_indices.insert( pair< size_t, unsigned int >( constraint->child().hash(), _regions.size() ) );
+      if( child.second ){
+        _regions.push_back( &constraint->child() );
+      }
+      _constraint_regions[ groundings[ i ].second ] = pair< unsigned int, unsigned int >( parent.first->second, child.first->second );
+    }
+  }
+  return;
+}
+
+void
+Feature_Table::
+clear( void ){
+  _feature_set = NULL;
+  _values.clear();
+  _regions.clear();
+  _constraint_regions.clear();
+  return;
+}
+
+/**
+ * returns the values of a grounding, or NULL if the grounding is not in the table
+ */
+const vector< vector< bool > >*
+Feature_Table::
+values( const Grounding* grounding )const{
+  map< const Grounding*, vector< vector< bool > > >::const_iterator it = _values.find( grounding );
+  if( it != _values.end() ){
+    return &it->second;
+  }
+  return NULL;
+}
+
+/**
+ * finds the indices in regions() of a constraint's parent and child regions, 
+ *   returning false if the grounding is not a constraint in the table
+ */
+bool
+Feature_Table::
+constraint_regions( const Grounding* grounding,
+                    unsigned int& parentIndex,
+                    unsigned int& childIndex )const{
+  map< const Grounding*, pair< unsigned int, unsigned int > >::const_iterator it = _constraint_regions.find( grounding );
+  if( it != _constraint_regions.end() ){
+    parentIndex = it->second.first;
+    childIndex = it->second.second;
+    return true;
+  }
+  return false;
+}
+
+namespace h2sl {
+  ostream&
+  operator<<( ostream& out,
+              const Feature_Table& other ) {
+    out << "size:" << other.values().size() << " regions:" << other.regions().size();
+    return out;
+  }
+}
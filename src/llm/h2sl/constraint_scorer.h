@@ -0,0 +1,87 @@
+/**
+ * @file    constraint_scorer.h
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The interface for a class used to score constraints from partial sums over
+ *   the features of their parent and child regions
+ */
+
+#ifndef H2SL_CONSTRAINT_SCORER_H
+#define H2SL_CONSTRAINT_SCORER_H
+
+#include <iostream>
+#include <vector>
+
+#include "h2sl/grounding.h"
+#include "h2sl/region.h"
+#include "h2sl/phrase.h"
+#include "h2sl/world.h"
+#include "h2sl/llm.h"
+
+namespace h2sl {
+  /**
+   * a log-linear model whose feature products are linear in one group of 
+   *   grounding features scores a constraint as a sum over that group; the 
+   *   features that depend on only the parent or the child region are summed 
+   *   once per region and the remaining features are evaluated per constraint
+   */
+  class Constraint_Scorer {
+  public:
+    Constraint_Scorer();
+    virtual ~Constraint_Scorer();
+    Constraint_Scorer( const Constraint_Scorer& other );
+    Constraint_Scorer& operator=( const Constraint_Scorer& other );
+
+    bool prepare( LLM* llm, const Phrase* phrase, const World* world, const Grounding* context, const std::vector< unsigned int >& cvs );
+    void fill_regions( const std::vector< const Region* >& regions, const std::vector< std::pair< const Phrase*, std::vector< Grounding* > > >& children, const Phrase* phrase, const World* world, const Grounding* context );
+    void pygx( const Grounding* grounding, const unsigned int& parentIndex, const unsigned int& childIndex, const std::vector< std::pair< const Phrase*, std::vector< Grounding* > > >& children, const Phrase* phrase, const World* world, const Grounding* context, const std::vector< std::vector< bool > >* groundingValues, std::vector< double >& pygxs );
+    void pygx( const Grounding* grounding, const Grounding* mirror, const unsigned int& parentIndex, const unsigned int& childIndex, const std::vector< std::pair< const Phrase*, std::vector< Grounding* > > >& children, const Phrase* phrase, const World* world, const Grounding* context, const std::vector< std::vector< bool > >* groundingValues, std::vector< double >& pygxs, std::vector< double >& mirrorPygxs );
+    void clear( void );
+
+    inline const bool& prepared( void )const{ return _prepared; };
+    inline const std::vector< unsigned int >& cvs( void )const{ return _cvs; };
+    inline const std::vector< std::vector< double > >& parent_scores( void )const{ return _parent_scores; };
+    inline const std::vector< std::vector< double > >& child_scores( void )const{ return _child_scores; };
+
+  protected:
+    LLM* _llm;
+    std::vector< unsigned int > _cvs;
+    std::vector< unsigned int > _grounding_groups;
+    std::vector< std::vector< std::vector< double > > > _weights;
+    std::vector< std::vector< double > > _parent_scores;
+    std::vector< std::vector< double > > _child_scores;
+    bool _prepared;
+
+  private:
+
+  };
+  std::ostream& operator<<( std::ostream& out, const Constraint_Scorer& other );
+}
+
+#endif /* H2SL_CONSTRAINT_SCORER_H */
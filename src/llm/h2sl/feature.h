@@ -38,6 +38,7 @@
 #include <libxml/tree.h>
 
 #include "h2sl/grounding.h"
+#include "h2sl/region.h"
 #include "h2sl/phrase.h"
 #include "h2sl/world.h"
 
@@ -50,6 +51,13 @@ namespace h2sl {
     NUM_FEATURE_TYPES
   } feature_type_t;
 
+  typedef enum {
+    FEATURE_CONSTRAINT_REGION_NONE,
+    FEATURE_CONSTRAINT_REGION_PARENT,
+    FEATURE_CONSTRAINT_REGION_CHILD,
+    NUM_FEATURE_CONSTRAINT_REGIONS
+  } feature_constraint_region_t;
+
   class Feature {
   public:
     Feature( const bool& invert = false );
@@ -59,6 +67,7 @@ namespace h2sl {
 
     virtual bool value( const unsigned int& cv, const Grounding* grounding, const std::vector< std::pair< const Phrase*, std::vector< Grounding* > > >& children, const Phrase* phrase, const World* world ) = 0;
     virtual bool value( const unsigned int& cv, const Grounding* grounding, const std::vector< std::pair< const Phrase*, std::vector< Grounding* > > >& children, const Phrase* phrase, const World* world, const Grounding* context );
+    virtual bool region_value( const unsigned int& cv, const Region* region, const std::vector< std::pair< const Phrase*, std::vector< Grounding* > > >& children, const Phrase* phrase, const World* world, const Grounding* context );
 
     virtual void to_xml( xmlDocPtr doc, xmlNodePtr root )const = 0;
 
@@ -67,6 +76,8 @@ namespace h2sl {
     inline bool& invert( void ){ return _invert; };
     inline const bool& invert( void )const{ return _invert; };
     virtual const feature_type_t type( void )const = 0;
+    virtual inline bool grounding_only( void )const{ return false; };
+    virtual inline const feature_constraint_region_t constraint_region( void )const{ return FEATURE_CONSTRAINT_REGION_NONE; };
     
   protected:
     bool _invert;
@@ -48,12 +48,14 @@ namespace h2sl {
 
     virtual bool value( const unsigned int& cv, const Grounding* grounding, const std::vector< std::pair< const Phrase*, std::vector< Grounding* > > >& children, const Phrase* phrase, const World* world );
     virtual bool value( const unsigned int& cv, const Grounding* grounding, const std::vector< std::pair< const Phrase*, std::vector< Grounding* > > >& children, const Phrase* phrase, const World* world, const Grounding* context );
+    virtual bool region_value( const unsigned int& cv, const Region* region, const std::vector< std::pair< const Phrase*, std::vector< Grounding* > > >& children, const Phrase* phrase, const World* world, const Grounding* context );
 
     virtual void to_xml( xmlDocPtr doc, xmlNodePtr root )const;
 
     virtual void from_xml( xmlNodePtr root );
 
     virtual inline const feature_type_t type( void )const{ return FEATURE_TYPE_GROUNDING; };
+    virtual inline const feature_constraint_region_t constraint_region( void )const{ return FEATURE_CONSTRAINT_REGION_CHILD; };
 
   protected:
 
@@ -61,6 +61,7 @@ namespace h2sl {
     const std::string& symbol( void )const;
 
     virtual inline const feature_type_t type( void )const{ return FEATURE_TYPE_GROUNDING; };
+    virtual inline bool grounding_only( void )const{ return true; };
 
   protected:
     std::string _key;
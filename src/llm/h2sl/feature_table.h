@@ -0,0 +1,84 @@
+/**
+ * @file    feature_table.h
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The interface for a class used to store the values of the grounding-only
+ *   features for the groundings of a search space
+ */
+
+#ifndef H2SL_FEATURE_TABLE_H
+#define H2SL_FEATURE_TABLE_H
+
+#include <iostream>
+#include <vector>
+#include <map>
+
+#include "h2sl/grounding.h"
+#include "h2sl/region.h"
+#include "h2sl/world.h"
+#include "h2sl/feature_set.h"
+
+namespace h2sl {
+  /**
+   * the values of the features that depend only on the grounding, evaluated 
+   *   once per (world, feature set) and keyed by the grounding pointers of 
+   *   the search space they were filled from; regions() holds the distinct
+   *   parent and child regions of the constraints so that features of a 
+   *   single constraint region can be evaluated once per region
+   */
+  class Feature_Table {
+  public:
+    Feature_Table();
+    virtual ~Feature_Table();
+    Feature_Table( const Feature_Table& other );
+    Feature_Table& operator=( const Feature_Table& other );
+
+    void fill( Feature_Set* featureSet, const std::vector< std::pair< unsigned int, Grounding* > >& groundings, const World* world );
+    void clear( void );
+
+    const std::vector< std::vector< bool > >* values( const Grounding* grounding )const;
+    bool constraint_regions( const Grounding* grounding, unsigned int& parentIndex, unsigned int& childIndex )const;
+
+    inline const Feature_Set* feature_set( void )const{ return _feature_set; };
+    inline const std::map< const Grounding*, std::vector< std::vector< bool > > >& values( void )const{ return _values; };
+    inline const std::vector< const Region* >& regions( void )const{ return _regions; };
+
+  protected:
+    const Feature_Set* _feature_set;
+    std::map< const Grounding*, std::vector< std::vector< bool > > > _values;
+    std::vector< const Region* > _regions;
+    std::map< const Grounding*, std::pair< unsigned int, unsigned int > > _constraint_regions;
+
+  private:
+
+  };
+  std::ostream& operator<<( std::ostream& out, const Feature_Table& other );
+}
+
+#endif /* H2SL_FEATURE_TABLE_H */
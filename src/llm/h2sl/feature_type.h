@@ -41,6 +41,7 @@ namespace h2sl {
     inline const unsigned int& symbol_type( void )const{ return _symbol_type; };
 
     virtual inline const feature_type_t type( void )const{ return FEATURE_TYPE_GROUNDING; };
+    virtual inline bool grounding_only( void )const{ return true; };
 
   protected:
     unsigned int _symbol_type;
@@ -37,6 +37,7 @@
 #include <map>
 #include <boost/algorithm/string.hpp>
 #include <boost/thread.hpp>
+#include <boost/functional/hash.hpp>
 #include <lbfgs.h>
 
 #include "h2sl/region.h"
@@ -439,6 +440,57 @@ train( vector< pair< unsigned int, LLM_X > >& examples,
   return;
 }
 
+/**
+ * evaluates the probability of every correspondence variable in one pass, so the 
+ *   grounding features are shared between the hypotheses; the grounding-only 
+ *   features are read from groundingValues when it is given
+ */
+void
+LLM::
+pygx( const Grounding* grounding,
+      const vector< pair< const Phrase*, vector< Grounding* > > >& children,
+      const Phrase* phrase,
+      const World* world,
+      const Grounding* context,
+      const vector< unsigned int >& cvs,
+      const vector< bool >& evaluateFeatureTypes,
+      vector< double >& pygxs,
+      const vector< vector< bool > >* groundingValues ){
+  double denominator = 0.0;
+  vector< unsigned int > indices;
+  vector< Feature* > features;
+  vector< bool > evaluate_feature_types = evaluateFeatureTypes;
+  pygxs.resize( cvs.size() );
+  for( unsigned int i = 0; i < cvs.size(); i++ ){
+    if( i != 0 ){
+      evaluate_feature_types[ FEATURE_TYPE_LANGUAGE ] = false;
+      evaluate_feature_types[ FEATURE_TYPE_GROUNDING ] = false;
+    }
+    double dp = 0.0;
+    _feature_set->indices( cvs[ i ], grounding, children, phrase, world, context, indices, features, evaluate_feature_types, groundingValues );
+    for( unsigned int j = 0; j < indices.size(); j++ ){
+      dp += _weights[ indices[ j ] ];
+    }
+    pygxs[ i ] = exp( dp );
+    denominator += pygxs[ i ];
+  }
+  for( unsigned int i = 0; i < cvs.size(); i++ ){
+    pygxs[ i ] /= denominator;
+  }
+  return;
+}
+
+/**
+ * hashes the weights, which identify a trained model of a given feature set
+ */
+size_t
+LLM::
+hash( void )const{
+  size_t seed = _weights.size();
+  boost::hash_range( seed, _weights.begin(), _weights.end() );
+  return seed;
+}
+
 void 
 LLM::
 to_xml( const string& filename )const{
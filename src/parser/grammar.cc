@@ -33,7 +33,9 @@
 
 #include <fstream>
 #include <sstream>
+#include <cmath>
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 #include <h2sl/phrase.h>
 #include <h2sl/grammar.h>
@@ -44,13 +46,28 @@ using namespace h2sl;
 Grammar::
 Grammar() : _terminals(),
             _non_terminals(),
-            _unit_productions() {
+            _unit_productions(),
+            _symbols(),
+            _symbol_indices(),
+            _terminal_symbols(),
+            _binary_rules(),
+            _binary_rule_pairs(),
+            _unit_symbols(),
+            _unit_types(),
+            _unit_log_probs(),
+            _unit_closures(),
+            _mask_blocks( 0 ),
+            _unit_closure_masks(),
+            _binary_pair_masks(),
+            _lexicon(),
+            _hash( 0 ) {
   for( unsigned int i = POS_CC; i < NUM_POS_TAGS; i++ ){
     _terminals.push_back( Grammar_Terminal( pos_t_to_std_string( ( pos_t )( i ) ) ) );
   }
   for( unsigned int i = PHRASE_NP; i < NUM_PHRASE_TYPES; i++ ){
     _terminals.push_back( Grammar_Terminal( Phrase::phrase_type_t_to_std_string( ( phrase_type_t )( i ) ) ) );
   }
+  compile();
 }
   
 Grammar::
@@ -61,7 +78,21 @@ Grammar::
 Grammar::
 Grammar( const Grammar& other ) : _terminals( other._terminals ),
                                   _non_terminals( other._non_terminals ),
-                                  _unit_productions( other._unit_productions ){
+                                  _unit_productions( other._unit_productions ),
+                                  _symbols( other._symbols ),
+                                  _symbol_indices( other._symbol_indices ),
+                                  _terminal_symbols( other._terminal_symbols ),
+                                  _binary_rules( other._binary_rules ),
+                                  _binary_rule_pairs( other._binary_rule_pairs ),
+                                  _unit_symbols( other._unit_symbols ),
+                                  _unit_types( other._unit_types ),
+                                  _unit_log_probs( other._unit_log_probs ),
+                                  _unit_closures( other._unit_closures ),
+                                  _mask_blocks( other._mask_blocks ),
+                                  _unit_closure_masks( other._unit_closure_masks ),
+                                  _binary_pair_masks( other._binary_pair_masks ),
+                                  _lexicon( other._lexicon ),
+                                  _hash( other._hash ){
 
 }
 
@@ -71,6 +102,20 @@ operator=( const Grammar& other ) {
   _terminals = other._terminals;
   _non_terminals = other._non_terminals;
   _unit_productions = other._unit_productions;
+  _symbols = other._symbols;
+  _symbol_indices = other._symbol_indices;
+  _terminal_symbols = other._terminal_symbols;
+  _binary_rules = other._binary_rules;
+  _binary_rule_pairs = other._binary_rule_pairs;
+  _unit_symbols = other._unit_symbols;
+  _unit_types = other._unit_types;
+  _unit_log_probs = other._unit_log_probs;
+  _unit_closures = other._unit_closures;
+  _mask_blocks = other._mask_blocks;
+  _unit_closure_masks = other._unit_closure_masks;
+  _binary_pair_masks = other._binary_pair_masks;
+  _lexicon = other._lexicon;
+  _hash = other._hash;
   return (*this);
 }
 
@@ -151,6 +196,7 @@ from_xml( xmlNodePtr root ){
     }
   }
   _compute_symbols();
+  compile();
   return;
 }
 
@@ -268,6 +314,143 @@ cnyify( void ){
       rule_changes++;  
     }
   }   
+  _compute_symbols();
+  compile();
+  return;
+}
+
+/**
+ * compiles the rules into indices of symbols() and the words of the terminals
+ *   into a lexicon of ( symbol index, log probability ) pairs so that the 
+ *   parser does not compare strings, and updates hash(); call again after 
+ *   editing the rules
+ */
+void
+Grammar::
+compile( void ){
+  _symbol_indices.clear();
+  for( unsigned int i = 0; i < _symbols.size(); i++ ){
+    _symbol_indices.insert( pair< string, unsigned int >( _symbols[ i ], i ) );
+  }
+
+  _terminal_symbols.resize( _terminals.size() );
+  for( unsigned int i = 0; i < _terminals.size(); i++ ){
+    _terminal_symbols[ i ] = symbol_index( _terminals[ i ].symbol() );
+  }
+
+  _lexicon.clear();
+  for( unsigned int i = 0; i < _terminals.size(); i++ ){
+    for( unsigned int j = 0; j < _terminals[ i ].words().size(); j++ ){
+      vector< pair< int, double > >& symbols = _lexicon[ _terminals[ i ].words()[ j ] ];
+      if( _terminal_symbols[ i ] >= 0 ){
+        bool new_symbol = true;
+        for( unsigned int k = 0; k < symbols.size(); k++ ){
+          if( symbols[ k ].first == _terminal_symbols[ i ] ){
+            new_symbol = false;
+          }
+        }
+        if( new_symbol ){
+          symbols.push_back( pair< int, double >( _terminal_symbols[ i ], log( _terminals[ i ].prob( j ) ) ) );
+        }
+      }
+    }
+  }
+
+  // unit_closures()[ i ][ j ] is true if symbol i reaches symbol j through one or more unit productions
+  _unit_symbols.resize( _unit_productions.size() );
+  _unit_types.resize( _unit_productions.size() );
+  _unit_log_probs.resize( _unit_productions.size() );
+  _unit_closures.assign( _symbols.size(), vector< bool >( _symbols.size(), false ) );
+  for( unsigned int i = 0; i < _unit_productions.size(); i++ ){
+    _unit_symbols[ i ] = symbol_index( _unit_productions[ i ].symbol() );
+    _unit_types[ i ] = symbol_index( Phrase::phrase_type_t_to_std_string( _unit_productions[ i ].type() ) );
+    _unit_log_probs[ i ] = log( _unit_productions[ i ].prob() );
+    if( ( _unit_symbols[ i ] >= 0 ) && ( _unit_types[ i ] >= 0 ) ){
+      _unit_closures[ _unit_symbols[ i ] ][ _unit_types[ i ] ] = true;
+    }
+  }
+  for( unsigned int i = 0; i < _symbols.size(); i++ ){
+    for( unsigned int j = 0; j < _symbols.size(); j++ ){
+      if( _unit_closures[ j ][ i ] ){
+        for( unsigned int k = 0; k < _symbols.size(); k++ ){
+          if( _unit_closures[ i ][ k ] ){
+            _unit_closures[ j ][ k ] = true;
+          }
+        }
+      }
+    }
+  }
+
+  // unit_closure_masks() holds, as a bitset of mask_blocks() words for each symbol, the symbols 
+  //   it reaches through the unit productions that do not close a cycle, so that every symbol 
+  //   a parser adds through the closure has a chain of unit productions that derives it
+  _mask_blocks = ( _symbols.size() + 63 ) / 64;
+  _unit_closure_masks.assign( _symbols.size() * _mask_blocks, 0 );
+  for( unsigned int i = 0; i < _unit_productions.size(); i++ ){
+    if( ( _unit_symbols[ i ] >= 0 ) && ( _unit_types[ i ] >= 0 ) && !_unit_closures[ _unit_types[ i ] ][ _unit_symbols[ i ] ] ){
+      _unit_closure_masks[ _unit_symbols[ i ] * _mask_blocks + _unit_types[ i ] / 64 ] |= ( ( uint64_t )( 1 ) << ( _unit_types[ i ] % 64 ) );
+    }
+  }
+  for( unsigned int i = 0; i < _symbols.size(); i++ ){
+    for( unsigned int j = 0; j < _symbols.size(); j++ ){
+      if( ( _unit_closure_masks[ j * _mask_blocks + i / 64 ] >> ( i % 64 ) ) & 1 ){
+        for( unsigned int k = 0; k < _mask_blocks; k++ ){
+          _unit_closure_masks[ j * _mask_blocks + k ] |= _unit_closure_masks[ i * _mask_blocks + k ];
+        }
+      }
+    }
+  }
+
+  _binary_rules.clear();
+  for( unsigned int i = 0; i < _non_terminals.size(); i++ ){
+    if( _non_terminals[ i ].is_cny() ){
+      _binary_rules.push_back( Grammar_Binary_Rule( symbol_index( _non_terminals[ i ].a() ), symbol_index( _non_terminals[ i ].b() ), symbol_index( _non_terminals[ i ].c() ), log( _non_terminals[ i ].prob() ) ) );
+    }
+  }
+
+  // binary_rule_pairs()[ b ] holds, in order of c, the indices of the rules a -> b c for each right symbol c
+  _binary_rule_pairs.assign( _symbols.size(), vector< pair< int, vector< unsigned int > > >() );
+  for( unsigned int i = 0; i < _binary_rules.size(); i++ ){
+    const Grammar_Binary_Rule& rule = _binary_rules[ i ];
+    if( ( rule.a < 0 ) || ( rule.b < 0 ) || ( rule.c < 0 ) ){
+      continue;
+    }
+    vector< pair< int, vector< unsigned int > > >& pairs = _binary_rule_pairs[ rule.b ];
+    vector< pair< int, vector< unsigned int > > >::iterator it = pairs.begin();
+    while( ( it != pairs.end() ) && ( it->first < rule.c ) ){
+      it++;
+    }
+    if( ( it == pairs.end() ) || ( it->first != rule.c ) ){
+      it = pairs.insert( it, pair< int, vector< unsigned int > >( rule.c, vector< unsigned int >() ) );
+    }
+    it->second.push_back( i );
+  }
+
+  // binary_pair_masks() holds, as a bitset for each symbol b, the right symbols c of its rules a -> b c
+  _binary_pair_masks.assign( _symbols.size() * _mask_blocks, 0 );
+  for( unsigned int i = 0; i < _symbols.size(); i++ ){
+    for( unsigned int j = 0; j < _binary_rule_pairs[ i ].size(); j++ ){
+      unsigned int c = _binary_rule_pairs[ i ][ j ].first;
+      _binary_pair_masks[ i * _mask_blocks + c / 64 ] |= ( ( uint64_t )( 1 ) << ( c % 64 ) );
+    }
+  }
+
+  // the content of the rules, so that parses cached for one version of the grammar are not reused for another
+  _hash = 0;
+  for( unsigned int i = 0; i < _terminals.size(); i++ ){
+    boost::hash_combine( _hash, _terminals[ i ].symbol() );
+    boost::hash_combine( _hash, _terminals[ i ].words() );
+    boost::hash_combine( _hash, _terminals[ i ].probs() );
+  }
+  for( unsigned int i = 0; i < _non_terminals.size(); i++ ){
+    boost::hash_combine( _hash, _non_terminals[ i ].elements() );
+    boost::hash_combine( _hash, _non_terminals[ i ].prob() );
+  }
+  for( unsigned int i = 0; i < _unit_productions.size(); i++ ){
+    boost::hash_combine( _hash, ( int )( _unit_productions[ i ].type() ) );
+    boost::hash_combine( _hash, _unit_productions[ i ].symbol() );
+    boost::hash_combine( _hash, _unit_productions[ i ].prob() );
+  }
   return;
 }
 
@@ -278,15 +461,7 @@ unknown_words( const string& text )const{
   vector< string > words;
   boost::split( words, text, boost::is_any_of( " " ) );
   for( unsigned int i = 0; i < words.size(); i++ ){
-    bool known_word = false;
-    for( unsigned int j = 0; j < _terminals.size(); j++ ){
-      for( unsigned int k = 0; k < _terminals[ j ].words().size(); k++ ){
-        if( words[ i ] == _terminals[ j ].words()[ k ] ){
-          known_word = true;
-        }
-      } 
-    }
-    if( !known_word ){
+    if( _lexicon.find( words[ i ] ) == _lexicon.end() ){
       unknown_words.push_back( words[ i ] );
     }
   }
@@ -304,6 +479,19 @@ terminal_rule( const string& symbol )const{
   return _terminals.front();
 }
 
+/**
+ * returns the index of a symbol in symbols(), or -1 if it is not a symbol of the grammar
+ */
+int
+Grammar::
+symbol_index( const string& symbol )const{
+  map< string, unsigned int >::const_iterator it = _symbol_indices.find( symbol );
+  if( it != _symbol_indices.end() ){
+    return it->second;
+  }
+  return -1;
+}
+
 void
 Grammar::
 _compute_symbols( void ){
@@ -121,6 +121,9 @@ to_xml( xmlDocPtr doc,
     }
     xmlNewProp( node, ( const xmlChar* )( "children" ), ( const xmlChar* )( children_string.str().c_str() ) );
   }
+  stringstream prob_string;
+  prob_string << _prob;
+  xmlNewProp( node, ( const xmlChar* )( "prob" ), ( const xmlChar* )( prob_string.str().c_str() ) );
   xmlAddChild( root, node );
   return;
 }
@@ -135,6 +138,7 @@ void
 Grammar_Non_Terminal::
 from_xml( xmlNodePtr root ){
   _elements.clear();
+  _prob = 1.0;
   if( root->type == XML_ELEMENT_NODE ){
     xmlChar * tmp = xmlGetProp( root, ( const xmlChar* )( "root" ) );
     if( tmp != NULL ){
@@ -152,6 +156,11 @@ from_xml( xmlNodePtr root ){
       }
       xmlFree( tmp );
     }
+    tmp = xmlGetProp( root, ( const xmlChar* )( "prob" ) );
+    if( tmp != NULL ){
+      _prob = strtof( ( char* )( tmp ), NULL );
+      xmlFree( tmp );
+    }
   }     
   return;
 }
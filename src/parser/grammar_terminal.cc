@@ -40,8 +40,10 @@ using namespace h2sl;
 
 Grammar_Terminal::
 Grammar_Terminal( const std::string& symbol,
-                        const vector< string >& words ) : _symbol( symbol ),
-                                                          _words( words ) {
+                        const vector< string >& words,
+                        const vector< double >& probs ) : _symbol( symbol ),
+                                                          _words( words ),
+                                                          _probs( probs ) {
 
 }
 
@@ -52,7 +54,8 @@ Grammar_Terminal::
 
 Grammar_Terminal::
 Grammar_Terminal( const Grammar_Terminal& other ) : _symbol( other._symbol ),
-                                                              _words( other._words ){
+                                                              _words( other._words ),
+                                                              _probs( other._probs ){
 
 }
 
@@ -61,6 +64,7 @@ Grammar_Terminal::
 operator=( const Grammar_Terminal& other ) {
   _symbol = other._symbol;
   _words = other._words;
+  _probs = other._probs;
   return (*this);
 }
 
@@ -84,6 +88,16 @@ to_xml( xmlDocPtr doc,
     }
   }
   xmlNewProp( node, ( const xmlChar* )( "words" ), ( const xmlChar* )( words_string.str().c_str() ) );
+  if( !_probs.empty() ){
+    stringstream probs_string;
+    for( unsigned int i = 0; i < _probs.size(); i++ ){
+      probs_string << _probs[ i ];
+      if( i != ( _probs.size() - 1 ) ){
+        probs_string << ",";
+      }
+    }
+    xmlNewProp( node, ( const xmlChar* )( "probs" ), ( const xmlChar* )( probs_string.str().c_str() ) );
+  }
   xmlAddChild( root, node );
   return;
 }
@@ -99,6 +113,7 @@ Grammar_Terminal::
 from_xml( xmlNodePtr root ){
   _symbol = "na";
   _words.clear();
+  _probs.clear();
   if( root->type == XML_ELEMENT_NODE ){
     xmlChar * tmp = xmlGetProp( root, ( const xmlChar* )( "symbol" ) );
     if( tmp != NULL ){
@@ -113,6 +128,18 @@ from_xml( xmlNodePtr root ){
       }
       xmlFree( tmp );
     }
+    tmp = xmlGetProp( root, ( const xmlChar* )( "probs" ) );
+    if( tmp != NULL ){
+      string probs_string = ( char* )( tmp );
+      if( !probs_string.empty() ){
+        vector< string > probs_strings;
+        boost::split( probs_strings, probs_string, boost::is_any_of( "," ) );
+        for( unsigned int i = 0; i < probs_strings.size(); i++ ){
+          _probs.push_back( strtof( probs_strings[ i ].c_str(), NULL ) );
+        }
+      }
+      xmlFree( tmp );
+    }
 
   }
   return;
@@ -31,6 +31,7 @@
  * The implementation of a class used to describe a unit production
  */
 
+#include <sstream>
 #include <h2sl/grammar_unit_production.h>
 
 using namespace std;
@@ -38,8 +39,10 @@ using namespace h2sl;
 
 Grammar_Unit_Production::
 Grammar_Unit_Production( const phrase_type_t& type,
-                              const string& symbol ) : _type( type ),
-                                                    _symbol( symbol ) {
+                              const string& symbol,
+                              const double& prob ) : _type( type ),
+                                                    _symbol( symbol ),
+                                                    _prob( prob ) {
 
 }
 
@@ -50,7 +53,8 @@ Grammar_Unit_Production::
 
 Grammar_Unit_Production::
 Grammar_Unit_Production( const Grammar_Unit_Production& other ) : _type( other._type ),
-                                                                            _symbol( other._symbol ){
+                                                                            _symbol( other._symbol ),
+                                                                            _prob( other._prob ){
 
 }
 
@@ -59,6 +63,7 @@ Grammar_Unit_Production::
 operator=( const Grammar_Unit_Production& other ) {
   _type = other._type;
   _symbol = other._symbol;
+  _prob = other._prob;
   return (*this);
 }
 
@@ -74,6 +79,9 @@ to_xml( xmlDocPtr doc, xmlNodePtr root )const{
   xmlNodePtr node = xmlNewDocNode( doc, NULL, ( const xmlChar* )( "grammar_unit_production" ), NULL );
   xmlNewProp( node, ( const xmlChar* )( "symbol" ), ( const xmlChar* )( _symbol.c_str() ) );
   xmlNewProp( node, ( const xmlChar* )( "type" ), ( const xmlChar* )( Phrase::phrase_type_t_to_std_string( _type ).c_str() ) );
+  stringstream prob_string;
+  prob_string << _prob;
+  xmlNewProp( node, ( const xmlChar* )( "prob" ), ( const xmlChar* )( prob_string.str().c_str() ) );
   xmlAddChild( root, node );
   return;
 }
@@ -87,6 +95,7 @@ from_xml( const std::string& filename ){
 void
 Grammar_Unit_Production::
 from_xml( xmlNodePtr root ){
+  _prob = 1.0;
   if( root->type == XML_ELEMENT_NODE ){
     xmlChar * tmp = xmlGetProp( root, ( const xmlChar* )( "type" ) );
     if( tmp != NULL ){
@@ -99,6 +108,11 @@ from_xml( xmlNodePtr root ){
       _symbol = ( char* )( tmp );
       xmlFree( tmp );
     }
+    tmp = xmlGetProp( root, ( const xmlChar* )( "prob" ) );
+    if( tmp != NULL ){
+      _prob = strtof( ( char* )( tmp ), NULL );
+      xmlFree( tmp );
+    }
   }
   return;
 }
@@ -107,7 +121,7 @@ namespace h2sl {
   ostream&
   operator<<( ostream& out,
               const Grammar_Unit_Production& other ) {
-    out << Phrase::phrase_type_t_to_std_string( other.type() ) << "-" << other.symbol();
+    out << Phrase::phrase_type_t_to_std_string( other.type() ) << "-" << other.symbol() << " prob:" << other.prob();
     return out;
   }
 
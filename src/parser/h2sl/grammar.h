@@ -36,7 +36,10 @@
 
 #include <iostream>
 #include <vector>
+#include <map>
+#include <stdint.h>
 #include <libxml/tree.h>
+#include <boost/unordered_map.hpp>
 
 #include <h2sl/grammar_terminal.h>
 #include <h2sl/grammar_non_terminal.h>
@@ -67,6 +70,21 @@ namespace h2sl {
     NUM_PHRASE_PLACEHOLDERS
   } grammar_placeholder_t;
 
+  /**
+   * a binary rule a -> b c compiled to indices into Grammar::symbols() with 
+   *   the log of its probability
+   */
+  class Grammar_Binary_Rule {
+  public:
+    Grammar_Binary_Rule( const int& a = -1, const int& b = -1, const int& c = -1, const double& logProb = 0.0 ) : a( a ), b( b ), c( c ), log_prob( logProb ) {};
+    virtual ~Grammar_Binary_Rule(){};
+
+    int a;
+    int b;
+    int c;
+    double log_prob;
+  };
+
   class Grammar {
   public:
     Grammar();
@@ -75,6 +93,7 @@ namespace h2sl {
     Grammar& operator=( const Grammar& other );
 
     void cnyify( void );
+    void compile( void );
 
     void to_xml( const std::string& filename )const;
     void to_xml( xmlDocPtr doc, xmlNodePtr root )const;
@@ -88,6 +107,7 @@ namespace h2sl {
     std::vector< std::string > unknown_words( const std::string& text )const;
 
     const Grammar_Terminal& terminal_rule( const std::string& symbol )const;
+    int symbol_index( const std::string& symbol )const;
  
     inline std::vector< Grammar_Terminal >& terminals( void ){ return _terminals; };
     inline const std::vector< Grammar_Terminal >& terminals( void )const{ return _terminals; };
@@ -96,6 +116,18 @@ namespace h2sl {
     inline std::vector< Grammar_Unit_Production >& unit_productions( void ){ return _unit_productions; };
     inline const std::vector< Grammar_Unit_Production >& unit_productions( void )const{ return _unit_productions; };
     inline const std::vector< std::string >& symbols( void )const{ return _symbols; };
+    inline const std::vector< int >& terminal_symbols( void )const{ return _terminal_symbols; };
+    inline const std::vector< Grammar_Binary_Rule >& binary_rules( void )const{ return _binary_rules; };
+    inline const std::vector< std::vector< std::pair< int, std::vector< unsigned int > > > >& binary_rule_pairs( void )const{ return _binary_rule_pairs; };
+    inline const std::vector< int >& unit_symbols( void )const{ return _unit_symbols; };
+    inline const std::vector< int >& unit_types( void )const{ return _unit_types; };
+    inline const std::vector< double >& unit_log_probs( void )const{ return _unit_log_probs; };
+    inline const std::vector< std::vector< bool > >& unit_closures( void )const{ return _unit_closures; };
+    inline const unsigned int& mask_blocks( void )const{ return _mask_blocks; };
+    inline const std::vector< uint64_t >& unit_closure_masks( void )const{ return _unit_closure_masks; };
+    inline const std::vector< uint64_t >& binary_pair_masks( void )const{ return _binary_pair_masks; };
+    inline const boost::unordered_map< std::string, std::vector< std::pair< int, double > > >& lexicon( void )const{ return _lexicon; };
+    inline const std::size_t& hash( void )const{ return _hash; };
 
   protected:
     void _compute_symbols( void );
@@ -104,6 +136,19 @@ namespace h2sl {
     std::vector< Grammar_Non_Terminal > _non_terminals;
     std::vector< Grammar_Unit_Production > _unit_productions;
     std::vector< std::string > _symbols;
+    std::map< std::string, unsigned int > _symbol_indices;
+    std::vector< int > _terminal_symbols;
+    std::vector< Grammar_Binary_Rule > _binary_rules;
+    std::vector< std::vector< std::pair< int, std::vector< unsigned int > > > > _binary_rule_pairs;
+    std::vector< int > _unit_symbols;
+    std::vector< int > _unit_types;
+    std::vector< double > _unit_log_probs;
+    std::vector< std::vector< bool > > _unit_closures;
+    unsigned int _mask_blocks;
+    std::vector< uint64_t > _unit_closure_masks;
+    std::vector< uint64_t > _binary_pair_masks;
+    boost::unordered_map< std::string, std::vector< std::pair< int, double > > > _lexicon;
+    std::size_t _hash;
   
   private:
 
@@ -43,7 +43,7 @@
 namespace h2sl {
   class Grammar_Terminal {
   public:
-    Grammar_Terminal( const std::string& symbol = "na", const std::vector< std::string >& words = std::vector< std::string >() );
+    Grammar_Terminal( const std::string& symbol = "na", const std::vector< std::string >& words = std::vector< std::string >(), const std::vector< double >& probs = std::vector< double >() );
     virtual ~Grammar_Terminal();
     Grammar_Terminal( const Grammar_Terminal& other );
     Grammar_Terminal& operator=( const Grammar_Terminal& other );
@@ -58,10 +58,14 @@ namespace h2sl {
     inline const std::string& symbol( void )const{ return _symbol; };
     inline std::vector< std::string >& words( void ){ return _words; };
     inline const std::vector< std::string >& words( void )const{ return _words; };
+    inline std::vector< double >& probs( void ){ return _probs; };
+    inline const std::vector< double >& probs( void )const{ return _probs; };
+    inline double prob( const unsigned int& index )const{ return ( index < _probs.size() ) ? _probs[ index ] : 1.0; };
 
   protected:
     std::string _symbol;
     std::vector< std::string > _words;
+    std::vector< double > _probs;
 
   private:
 
@@ -42,7 +42,7 @@
 namespace h2sl {
   class Grammar_Unit_Production {
   public:
-    Grammar_Unit_Production( const phrase_type_t& type = PHRASE_UNKNOWN, const std::string& symbol = "UNKNOWN" );
+    Grammar_Unit_Production( const phrase_type_t& type = PHRASE_UNKNOWN, const std::string& symbol = "UNKNOWN", const double& prob = 1.0 );
     virtual ~Grammar_Unit_Production();
     Grammar_Unit_Production( const Grammar_Unit_Production& other );
     Grammar_Unit_Production& operator=( const Grammar_Unit_Production& other );
@@ -57,10 +57,13 @@ namespace h2sl {
     inline const phrase_type_t& type( void )const{ return _type; };
     inline std::string& symbol( void ){ return _symbol; };
     inline const std::string& symbol( void )const{ return _symbol; };
+    inline double& prob( void ){ return _prob; };
+    inline const double& prob( void )const{ return _prob; };
 
   protected:
     phrase_type_t _type;
     std::string _symbol;
+    double _prob;
 
   private:
 
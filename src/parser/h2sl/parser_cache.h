@@ -0,0 +1,93 @@
+/**
+ * @file    parser_cache.h
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The definition of a class that caches the parses of another parser
+ */
+
+#ifndef H2SL_PARSER_CACHE_H
+#define H2SL_PARSER_CACHE_H
+
+#include <iostream>
+#include <sstream>
+#include <list>
+#include <boost/unordered_map.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "h2sl/parser.h"
+
+namespace h2sl {
+  /**
+   * a bounded cache of the parses of another parser, most recently used 
+   *   first; entries are keyed on the normalized words of the text and the 
+   *   hash of the grammar, every call returns its own copies of the cached 
+   *   phrases and a size of zero disables the cache; the parser is not owned 
+   *   and the cache should be cleared after changing its settings
+   */
+  template< class T >
+  class Parser_Cache: public Parser<T> {
+  public:
+    Parser_Cache( const Parser<T>* parser = NULL, const unsigned int& size = 128 );
+    virtual ~Parser_Cache();
+    Parser_Cache( const Parser_Cache<T>& other );
+    Parser_Cache<T>& operator=( const Parser_Cache<T>& other );
+
+    virtual bool parse( const Grammar& grammar, const std::string& text, std::vector<T*>& phrases, const bool& debug = false )const;
+    void clear( void );
+
+    unsigned int num_entries( void )const;
+    unsigned int num_hits( void )const;
+    unsigned int num_misses( void )const;
+
+    inline const Parser<T>* parser( void )const{ return _parser; };
+    inline const unsigned int& size( void )const{ return _size; };
+
+  protected:
+    std::string _key( const Grammar& grammar, const std::string& text )const;
+    void _clone( const std::vector< T* >& source, std::vector< T* >& destination )const;
+    void _clear( std::list< std::pair< std::string, std::vector< T* > > >& entries )const;
+
+    const Parser<T>* _parser;
+    unsigned int _size;
+    mutable std::list< std::pair< std::string, std::vector< T* > > > _entries;
+    mutable boost::unordered_map< std::string, typename std::list< std::pair< std::string, std::vector< T* > > >::iterator > _index;
+    mutable unsigned int _num_hits;
+    mutable unsigned int _num_misses;
+    mutable boost::mutex _mutex;
+
+  private:
+
+  };
+
+  template< class T >
+  std::ostream& operator<<( std::ostream& out, const Parser_Cache<T>& other );
+  #include "h2sl/parser_cache.ipp"
+}
+
+#endif /* H2SL_PARSER_CACHE_H */
@@ -0,0 +1,235 @@
+/**
+ * @file    parser_cache.ipp
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of a class that caches the parses of another parser
+ */
+
+template< class T >
+Parser_Cache<T>::
+Parser_Cache( const Parser<T>* parser,
+              const unsigned int& size ) : Parser<T>(),
+                                            _parser( parser ),
+                                            _size( size ),
+                                            _entries(),
+                                            _index(),
+                                            _num_hits( 0 ),
+                                            _num_misses( 0 ),
+                                            _mutex() {
+
+}
+
+template< class T >
+Parser_Cache<T>::
+~Parser_Cache() {
+  _clear( _entries );
+}
+
+template< class T >
+Parser_Cache<T>::
+Parser_Cache( const Parser_Cache<T>& other ) : Parser<T>( other ),
+                                                _parser( other._parser ),
+                                                _size( other._size ),
+                                                _entries(),
+                                                _index(),
+                                                _num_hits( 0 ),
+                                                _num_misses( 0 ),
+                                                _mutex() {
+  boost::mutex::scoped_lock lock( other._mutex );
+  for( typename std::list< std::pair< std::string, std::vector< T* > > >::const_iterator it = other._entries.begin(); it != other._entries.end(); it++ ){
+    _entries.push_back( std::pair< std::string, std::vector< T* > >( it->first, std::vector< T* >() ) );
+    _clone( it->second, _entries.back().second );
+    _index[ it->first ] = --_entries.end();
+  }
+  _num_hits = other._num_hits;
+  _num_misses = other._num_misses;
+}
+
+template< class T >
+Parser_Cache<T>&
+Parser_Cache<T>::
+operator=( const Parser_Cache<T>& other ) {
+  if( this != &other ){
+    Parser_Cache<T> tmp( other );
+    boost::mutex::scoped_lock lock( _mutex );
+    _parser = tmp._parser;
+    _size = tmp._size;
+    _entries.swap( tmp._entries );
+    _index.swap( tmp._index );
+    _num_hits = tmp._num_hits;
+    _num_misses = tmp._num_misses;
+  }
+  return (*this);
+}
+
+/**
+ * returns copies of the cached phrases of the text, parsing it with the 
+ *   cached parser on a miss; the parser runs without the lock held, and 
+ *   debug parses always run
+ */
+template< class T >
+bool
+Parser_Cache<T>::
+parse( const Grammar& grammar,
+        const std::string& text,
+        std::vector<T*>& phrases,
+        const bool& debug )const{
+  for( unsigned int i = 0; i < phrases.size(); i++ ){
+    if( phrases[ i ] != NULL ){
+      delete phrases[ i ];
+      phrases[ i ] = NULL;
+    }
+  }
+  phrases.clear();
+
+  if( _parser == NULL ){
+    return false;
+  } else if( debug || ( _size == 0 ) ){
+    return _parser->parse( grammar, text, phrases, debug );
+  }
+
+  std::string key = _key( grammar, text );
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+    typename boost::unordered_map< std::string, typename std::list< std::pair< std::string, std::vector< T* > > >::iterator >::iterator it = _index.find( key );
+    if( it != _index.end() ){
+      _entries.splice( _entries.begin(), _entries, it->second );
+      _num_hits++;
+      _clone( _entries.front().second, phrases );
+      return !phrases.empty();
+    }
+    _num_misses++;
+  }
+
+  bool success = _parser->parse( grammar, text, phrases, debug );
+
+  boost::mutex::scoped_lock lock( _mutex );
+  if( _index.find( key ) == _index.end() ){
+    _entries.push_front( std::pair< std::string, std::vector< T* > >( key, std::vector< T* >() ) );
+    _clone( phrases, _entries.front().second );
+    _index[ key ] = _entries.begin();
+
+    while( _entries.size() > _size ){
+      _index.erase( _entries.back().first );
+      std::list< std::pair< std::string, std::vector< T* > > > evicted;
+      evicted.splice( evicted.begin(), _entries, --_entries.end() );
+      _clear( evicted );
+    }
+  }
+  return success;
+}
+
+template< class T >
+void
+Parser_Cache<T>::
+clear( void ){
+  boost::mutex::scoped_lock lock( _mutex );
+  _clear( _entries );
+  _index.clear();
+  return;
+}
+
+template< class T >
+unsigned int
+Parser_Cache<T>::
+num_entries( void )const{
+  boost::mutex::scoped_lock lock( _mutex );
+  return _entries.size();
+}
+
+template< class T >
+unsigned int
+Parser_Cache<T>::
+num_hits( void )const{
+  boost::mutex::scoped_lock lock( _mutex );
+  return _num_hits;
+}
+
+template< class T >
+unsigned int
+Parser_Cache<T>::
+num_misses( void )const{
+  boost::mutex::scoped_lock lock( _mutex );
+  return _num_misses;
+}
+
+/**
+ * the hash of the grammar followed by the words of the text as the parsers 
+ *   split them, so texts that differ only in commas share an entry
+ */
+template< class T >
+std::string
+Parser_Cache<T>::
+_key( const Grammar& grammar,
+      const std::string& text )const{
+  std::vector< Word > words;
+  this->_text_to_words( text, words );
+
+  std::stringstream key;
+  key << grammar.hash();
+  for( unsigned int i = 0; i < words.size(); i++ ){
+    key << "|" << words[ i ].text();
+  }
+  return key.str();
+}
+
+template< class T >
+void
+Parser_Cache<T>::
+_clone( const std::vector< T* >& source,
+        std::vector< T* >& destination )const{
+  for( unsigned int i = 0; i < source.size(); i++ ){
+    destination.push_back( dynamic_cast< T* >( source[ i ]->dup() ) );
+  }
+  return;
+}
+
+template< class T >
+void
+Parser_Cache<T>::
+_clear( std::list< std::pair< std::string, std::vector< T* > > >& entries )const{
+  for( typename std::list< std::pair< std::string, std::vector< T* > > >::iterator it = entries.begin(); it != entries.end(); it++ ){
+    for( unsigned int i = 0; i < it->second.size(); i++ ){
+      if( it->second[ i ] != NULL ){
+        delete it->second[ i ];
+        it->second[ i ] = NULL;
+      }
+    }
+  }
+  entries.clear();
+  return;
+}
+
+template< class T >
+std::ostream&
+operator<<( std::ostream& out,
+            const Parser_Cache<T>& other ) {
+  out << "size:" << other.num_entries() << "/" << other.size() << " hits:" << other.num_hits() << " misses:" << other.num_misses();
+  return out;
+}
@@ -37,86 +37,234 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <map>
+#include <algorithm>
+#include <set>
+#include <queue>
+#include <functional>
+#include <limits>
+#include <cmath>
+#include <stdint.h>
+#include <boost/thread.hpp>
 
 #include "h2sl/common.h"
 #include "h2sl/parser.h"
 
 namespace h2sl {
-  class CYK_Cell {
+  /**
+   * a backpointer from a chart entry to the entries of its children (-1 for 
+   *   none); rule indexes Grammar::binary_rules() for a binary backpointer and 
+   *   Grammar::unit_productions() for a unit one ( second is -1 ), log_prob is 
+   *   the log probability of that rule, rank is its position among the entry's 
+   *   backpointers and next is the index of the entry's following backpointer 
+   *   in the table's arena, or -1
+   */
+  class CYK_Backpointer {
   public:
-    CYK_Cell( const bool& value = false, const std::vector< std::pair< CYK_Cell*, CYK_Cell* > >& backpointers = std::vector< std::pair< CYK_Cell*, CYK_Cell* > >() ) : _value( value ), _backpointers( backpointers ) {};
-    virtual ~CYK_Cell(){};
-    CYK_Cell( const CYK_Cell& other ) : _value( other._value ), _backpointers( other._backpointers ){};
-
-    void add_backpointer( const std::pair< CYK_Cell*, CYK_Cell* >& backpointer ){
-      bool new_backpointer = true;
-      for( unsigned int i = 0; i < _backpointers.size(); i++ ){
-        if( ( ( _backpointers[ i ].first == backpointer.first ) && ( _backpointers[ i ].second == backpointer.second ) ) || ( ( _backpointers[ i ].second == backpointer.first ) && ( _backpointers[ i ].first == backpointer.second ) ) ){
-          new_backpointer = false;
-        }
+    CYK_Backpointer( const int& first = -1, const int& second = -1, const int& rule = -1, const double& logProb = 0.0, const unsigned int& rank = 0 ) : first( first ), second( second ), rule( rule ), log_prob( logProb ), rank( rank ), next( -1 ) {};
+    virtual ~CYK_Backpointer(){};
+
+    int first;
+    int second;
+    int rule;
+    double log_prob;
+    unsigned int rank;
+    int next;
+  };
+
+  /**
+   * a derivation of a chart entry in the packed forest: the backpointer it 
+   *   uses, the derivation ranks of its first and second children, and the 
+   *   ( entry, backpointer rank ) choices with a nonzero rank below it sorted 
+   *   by entry; derivations are ordered by decreasing log probability and then 
+   *   lexicographically by those choices, which without probabilities matches 
+   *   enumerating every backpointer combination in entry order
+   */
+  class CYK_Derivation {
+  public:
+    CYK_Derivation( const int& backpointer = -1, const unsigned int& firstRank = 0, const unsigned int& secondRank = 0, const double& logProb = 0.0 ) : backpointer( backpointer ), first_rank( firstRank ), second_rank( secondRank ), log_prob( logProb ), choices() {};
+    virtual ~CYK_Derivation(){};
+
+    bool operator<( const CYK_Derivation& other )const{
+      if( log_prob != other.log_prob ){
+        return log_prob > other.log_prob;
       }
-      if( new_backpointer ){
-        _backpointers.push_back( backpointer );
+      for( unsigned int i = 0; ( i < choices.size() ) && ( i < other.choices.size() ); i++ ){
+        if( choices[ i ].first != other.choices[ i ].first ){
+          return choices[ i ].first > other.choices[ i ].first;
+        } else if( choices[ i ].second != other.choices[ i ].second ){
+          return choices[ i ].second < other.choices[ i ].second;
+        }
       }
-      return;
-    }
+      return choices.size() < other.choices.size();
+    };
+    bool operator>( const CYK_Derivation& other )const{ return other < *this; };
 
-    inline bool& value( void ){ return _value; };
-    inline const bool& value( void )const{ return _value; };
-    inline std::vector< std::pair< CYK_Cell*, CYK_Cell* > >& backpointers( void ){ return _backpointers; };
-    inline const std::vector< std::pair< CYK_Cell*, CYK_Cell* > >& backpointers( void )const{ return _backpointers; };
-
-  protected:
-    bool _value;
-    std::vector< std::pair< CYK_Cell*, CYK_Cell* > > _backpointers;
+    int backpointer;
+    unsigned int first_rank;
+    unsigned int second_rank;
+    double log_prob;
+    std::vector< std::pair< unsigned int, unsigned int > > choices;
   };
 
+  /**
+   * the chart is a single array holding a bitset of symbols for every span 
+   *   ( i, j ) that starts at word i and covers j + 1 words; an entry is a 
+   *   ( span, symbol ) pair and its backpointers are chained in one arena; 
+   *   when probabilistic, every entry also holds its viterbi log probability 
+   *   and spans other than the sentence keep at most beamWidth symbols; the 
+   *   spans of each length are split across numThreads threads for sentences 
+   *   of at least parallelThreshold words; spans are laid out for up to a 
+   *   capacity of words so that appended words only add the spans that end 
+   *   at them
+   */
   template< class T >
   class CYK_Table {
   public:
-    CYK_Table( const std::vector< Word >& words = std::vector< Word >(), const std::vector< std::string >& symbols = std::vector< std::string >() );
+    CYK_Table( const std::vector< Word >& words = std::vector< Word >(), const std::vector< std::string >& symbols = std::vector< std::string >(), const bool& probabilistic = false, const unsigned int& beamWidth = 0, const unsigned int& numThreads = 1, const unsigned int& parallelThreshold = 0 );
     virtual ~CYK_Table();
-    CYK_Cell& operator()( const unsigned int& i, const unsigned int& j, const unsigned int& k );
-    const CYK_Cell& operator()( const unsigned int& i, const unsigned int& j, const unsigned int& k )const;
+    bool operator()( const unsigned int& i, const unsigned int& j, const unsigned int& k )const;
+    void set( const unsigned int& i, const unsigned int& j, const unsigned int& k );
+    void add_backpointer( const unsigned int& entry, const int& first, const int& second, const int& rule = -1, const double& logProb = 0.0 );
     void fill( const Grammar& grammar );
-    void parse( const Grammar& grammar, std::vector< T* >& phrases );
-    void traverse( const Grammar& grammar, T* phrase, CYK_Cell* root )const;
+    void append( const Grammar& grammar, const Word& word );
+    static void fill_spans_thread( CYK_Table<T>* table, const Grammar* grammar, const unsigned int j, const unsigned int first, const unsigned int last, std::vector< std::vector< CYK_Backpointer > >* backpointers );
+    void parse( const Grammar& grammar, std::vector< T* >& phrases, const unsigned int& maxParses = 0 );
+    bool count_rules( const Grammar& grammar, const T* phrase, std::vector< double >& binaryRuleCounts, std::vector< double >& unitProductionCounts );
+    void traverse( const Grammar& grammar, T* phrase, const unsigned int& entry, const unsigned int& rank )const;
 
+    inline unsigned int entry( const unsigned int& i, const unsigned int& j, const unsigned int& k )const{ return ( i * _capacity + j ) * _symbols.size() + k; };
+    inline unsigned int entry_symbol( const unsigned int& entry )const{ return entry % _symbols.size(); };
+    inline unsigned int entry_start( const unsigned int& entry )const{ return entry / _symbols.size() / _capacity; };
+    inline unsigned int num_backpointers( const unsigned int& entry )const{ return _num_backpointers[ entry ]; };
+    inline const int& first_backpointer( const unsigned int& entry )const{ return _first_backpointers[ entry ]; };
+    inline const std::vector< CYK_Backpointer >& backpointers( void )const{ return _backpointers; };
+    inline const double& log_prob( const unsigned int& entry )const{ return _log_probs[ entry ]; };
     inline const std::vector< Word >& words( void )const{ return _words; };
     inline const std::vector< std::string >& symbols( void )const{ return _symbols; };
 
   protected:
-    bool _find_index( const CYK_Cell* cell, std::vector< unsigned int >& index )const;
-    int _symbol_to_index( const std::string& symbol, const std::vector< std::string >& symbols );
+    inline const uint64_t* _span( const unsigned int& i, const unsigned int& j )const{ return &_chart[ ( i * _capacity + j ) * _num_blocks ]; };
+    inline uint64_t* _span( const unsigned int& i, const unsigned int& j ){ return &_chart[ ( i * _capacity + j ) * _num_blocks ]; };
+    bool _seed( const Grammar& grammar, const unsigned int& i );
+    void _reserve( const unsigned int& capacity );
+    void _fill_span( const Grammar& grammar, const unsigned int& i, const unsigned int& j, std::vector< CYK_Backpointer >& backpointers );
+    void _add_backpointer( std::vector< CYK_Backpointer >& backpointers, const unsigned int& entry, const int& first, const int& second, const int& rule, const double& logProb );
+    void _append_backpointers( const unsigned int& i, const unsigned int& j, std::vector< CYK_Backpointer >& backpointers );
+    void _close_units( const Grammar& grammar, const unsigned int& i, const unsigned int& j, std::vector< CYK_Backpointer >& backpointers );
+    void _prune( const unsigned int& i, const unsigned int& j );
+    void _initialize_derivations( std::vector< unsigned int >& roots );
+    int _next_root( const std::vector< unsigned int >& roots, const std::vector< unsigned int >& ranks );
+    void _count_rules( const unsigned int& entry, const unsigned int& rank, std::vector< double >& binaryRuleCounts, std::vector< double >& unitProductionCounts )const;
+    bool _expands( const int& entry )const;
+    bool _kth_derivation( const unsigned int& entry, const unsigned int& k );
+    void _next_derivations( const unsigned int& entry, const CYK_Derivation& derivation );
+    void _push_candidate( const unsigned int& entry, const int& backpointer, const unsigned int& firstRank, const unsigned int& secondRank );
+    std::string _phrase_key( const Phrase* phrase, const bool& text = true )const;
     std::string _symbol_from_index( const unsigned int& index, const std::vector< std::string >& symbols );
 
-    CYK_Cell *** _cells;
-    const std::vector< Word > _words;
+    std::vector< Word > _words;
     const std::vector< std::string > _symbols;
+    const bool _probabilistic;
+    const unsigned int _beam_width;
+    const unsigned int _num_threads;
+    const unsigned int _parallel_threshold;
+    unsigned int _num_blocks;
+    unsigned int _capacity;
+    std::vector< uint64_t > _chart;
+    std::vector< int > _first_backpointers;
+    std::vector< int > _last_backpointers;
+    std::vector< unsigned int > _num_backpointers;
+    std::vector< CYK_Backpointer > _backpointers;
+    std::vector< double > _log_probs;
+    std::vector< int > _symbol_pos_tags;
+    std::vector< int > _symbol_phrase_types;
+    std::vector< bool > _symbol_placeholders;
+    std::vector< std::vector< CYK_Derivation > > _derivations;
+    std::vector< std::priority_queue< CYK_Derivation, std::vector< CYK_Derivation >, std::greater< CYK_Derivation > > > _candidates;
+    std::vector< std::set< std::pair< int, std::pair< unsigned int, unsigned int > > > > _candidate_keys;
+    std::vector< bool > _derivations_initialized;
 
   };
   
   template< class T >
   std::ostream& operator<<( std::ostream& out, const CYK_Table<T>& other );
 
+  template< class T >
+  class CYK_Session;
+
   template< class T >
   class Parser_CYK: public Parser<T> {
   public:
-    Parser_CYK();
+    Parser_CYK( const unsigned int& maxParses = 0, const bool& probabilistic = false, const unsigned int& beamWidth = 0, const unsigned int& numThreads = 1, const unsigned int& parallelThreshold = 12 );
     virtual ~Parser_CYK();
     Parser_CYK( const Parser_CYK<T>& other );
     Parser_CYK<T>& operator=( const Parser_CYK<T>& other );
 
     virtual bool parse( const Grammar& grammar, const std::string& text, std::vector<T*>& phrases, const bool& debug = false )const;
+    unsigned int estimate( Grammar& grammar, const std::vector< std::pair< std::string, const T* > >& examples )const;
+
+    inline unsigned int& max_parses( void ){ return _max_parses; };
+    inline const unsigned int& max_parses( void )const{ return _max_parses; };
+    inline bool& probabilistic( void ){ return _probabilistic; };
+    inline const bool& probabilistic( void )const{ return _probabilistic; };
+    inline unsigned int& beam_width( void ){ return _beam_width; };
+    inline const unsigned int& beam_width( void )const{ return _beam_width; };
+    inline unsigned int& num_threads( void ){ return _num_threads; };
+    inline const unsigned int& num_threads( void )const{ return _num_threads; };
+    inline unsigned int& parallel_threshold( void ){ return _parallel_threshold; };
+    inline const unsigned int& parallel_threshold( void )const{ return _parallel_threshold; };
 
   protected:
+    void _count_words( const Grammar& grammar, const Phrase* phrase, std::vector< std::vector< double > >& terminalCounts )const;
+
+    unsigned int _max_parses;
+    bool _probabilistic;
+    unsigned int _beam_width;
+    unsigned int _num_threads;
+    unsigned int _parallel_threshold;
 
   private:
+    friend class CYK_Session<T>;
 
   };
 
   template< class T >
   std::ostream& operator<<( std::ostream& out, const Parser_CYK<T>& other );
+
+  /**
+   * an incremental parse of a sentence whose words arrive one at a time, 
+   *   such as from speech recognition; every appended word only fills the 
+   *   chart spans that end at it, and the complete parses of the words so 
+   *   far are available at any point
+   */
+  template< class T >
+  class CYK_Session {
+  public:
+    CYK_Session( const Grammar& grammar, const Parser_CYK<T>& parser = Parser_CYK<T>() );
+    virtual ~CYK_Session();
+    CYK_Session( const CYK_Session<T>& other );
+    CYK_Session<T>& operator=( const CYK_Session<T>& other );
+
+    void append( const std::string& text );
+    bool parses( std::vector< T* >& phrases );
+    void clear( void );
+
+    inline const std::vector< Word >& words( void )const{ return _cyk_table->words(); };
+    inline const Parser_CYK<T>& parser( void )const{ return _parser; };
+    inline const CYK_Table<T>& cyk_table( void )const{ return *_cyk_table; };
+
+  protected:
+    const Grammar * _grammar;
+    Parser_CYK<T> _parser;
+    CYK_Table<T> * _cyk_table;
+
+  private:
+
+  };
+
+  template< class T >
+  std::ostream& operator<<( std::ostream& out, const CYK_Session<T>& other );
   #include "h2sl/parser_cyk.ipp"
 }
 
@@ -34,15 +34,45 @@
 template< class T >
 CYK_Table<T>::
 CYK_Table( const std::vector< Word >& words,
-            const std::vector< std::string >& symbols ) : _cells( NULL ),
-                                                          _words( words ),
-                                                          _symbols( symbols ) {
-  if( ( _words.size() > 0 ) && ( _symbols.size() > 0 ) ){
-    _cells = new CYK_Cell**[ _words.size() ];
-    for( unsigned int i = 0; i < _words.size(); i++ ){
-      _cells[ i ] = new CYK_Cell*[ _words.size() ];
-      for( unsigned int j = 0; j < _words.size(); j++ ){
-        _cells[ i ][ j ] = new CYK_Cell[ _symbols.size() ];
+            const std::vector< std::string >& symbols,
+            const bool& probabilistic,
+            const unsigned int& beamWidth,
+            const unsigned int& numThreads,
+            const unsigned int& parallelThreshold ) : _words( words ),
+                                                          _symbols( symbols ),
+                                                          _probabilistic( probabilistic ),
+                                                          _beam_width( beamWidth ),
+                                                          _num_threads( numThreads ),
+                                                          _parallel_threshold( parallelThreshold ),
+                                                          _num_blocks( ( symbols.size() + 63 ) / 64 ),
+                                                          _capacity( words.size() ),
+                                                          _chart( words.size() * words.size() * ( ( symbols.size() + 63 ) / 64 ), 0 ),
+                                                          _first_backpointers( words.size() * words.size() * symbols.size(), -1 ),
+                                                          _last_backpointers( words.size() * words.size() * symbols.size(), -1 ),
+                                                          _num_backpointers( words.size() * words.size() * symbols.size(), 0 ),
+                                                          _backpointers(),
+                                                          _log_probs( words.size() * words.size() * symbols.size(), -std::numeric_limits< double >::infinity() ),
+                                                          _symbol_pos_tags( symbols.size(), -1 ),
+                                                          _symbol_phrase_types( symbols.size(), -1 ),
+                                                          _symbol_placeholders( symbols.size(), false ),
+                                                          _derivations(),
+                                                          _candidates(),
+                                                          _candidate_keys(),
+                                                          _derivations_initialized() {
+  for( unsigned int i = 0; i < _symbols.size(); i++ ){
+    for( unsigned int j = 0; j < NUM_POS_TAGS; j++ ){
+      if( pos_t_to_std_string( ( pos_t )( j ) ) == _symbols[ i ] ){
+        _symbol_pos_tags[ i ] = j;
+      }
+    }
+    for( unsigned int j = 0; j < NUM_PHRASE_TYPES; j++ ){
+      if( Phrase::phrase_type_t_to_std_string( ( phrase_type_t )( j ) ) == _symbols[ i ] ){
+        _symbol_phrase_types[ i ] = j;
+      }
+    }
+    for( unsigned int j = 0; j < NUM_PHRASE_PLACEHOLDERS; j++ ){
+      if( Grammar::grammar_placeholder_t_to_std_string( ( grammar_placeholder_t )( j ) ) == _symbols[ i ] ){
+        _symbol_placeholders[ i ] = true;
       }
     }
   }
@@ -51,147 +81,392 @@ CYK_Table( const std::vector< Word >& words,
 template< class T >
 CYK_Table<T>::
 ~CYK_Table() {
-  if( _cells != NULL ){
-    for( unsigned int i = 0; i < _words.size(); i++ ){
-      for( unsigned int j = 0; j < _words.size(); j++ ){
-        if( _cells[ i ][ j ] != NULL ){
-          delete[] _cells[ i ][ j ];
-          _cells[ i ][ j ] = NULL;
-        }
-      }
-      if( _cells[ i ] != NULL ){
-        delete[] _cells[ i ];
-        _cells[ i ] = NULL;
-      }
-    }
-    delete[] _cells;
-    _cells = NULL;
-  }
+
 }
 
 template< class T >
-CYK_Cell&
+bool
 CYK_Table<T>::
 operator()( const unsigned int& i,
             const unsigned int& j,
-            const unsigned int& k ){
+            const unsigned int& k )const{
   assert( ( i < _words.size() ) && ( j < _words.size() ) && ( k < _symbols.size() ) );
-  return _cells[ i ][ j ][ k ];
+  return ( _span( i, j )[ k / 64 ] >> ( k % 64 ) ) & 1;
 }
 
 template< class T >
-const CYK_Cell&
+void
 CYK_Table<T>::
-operator()( const unsigned int& i,
-            const unsigned int& j,
-            const unsigned int& k )const{
+set( const unsigned int& i,
+      const unsigned int& j,
+      const unsigned int& k ){
   assert( ( i < _words.size() ) && ( j < _words.size() ) && ( k < _symbols.size() ) );
-  return _cells[ i ][ j ][ k ];
+  _span( i, j )[ k / 64 ] |= ( ( uint64_t )( 1 ) << ( k % 64 ) );
+  return;
+}
+
+template< class T >
+void
+CYK_Table<T>::
+add_backpointer( const unsigned int& entry,
+                  const int& first,
+                  const int& second,
+                  const int& rule,
+                  const double& logProb ){
+  _add_backpointer( _backpointers, entry, first, second, rule, logProb );
+  return;
 }
 
 template< class T >
 void
 CYK_Table<T>::
 fill( const Grammar& grammar ){
+  // an unknown word leaves a span that no rule can cover, so nothing parses
   for( unsigned int i = 0; i < _words.size(); i++ ){
-    for( unsigned int j = 0; j < grammar.terminals().size(); j++ ){
-      for( unsigned int k = 0; k < grammar.terminals()[ j ].words().size(); k++ ){
-        if( _words[ i ].text() == grammar.terminals()[ j ].words()[ k ] ){
-          int index = _symbol_to_index( grammar.terminals()[ j ].symbol(), grammar.symbols() );
-          if( index >= 0 ){
-            (*this)( i, 0, index ) = true;
-          }
-        }
+    if( !_seed( grammar, i ) ){
+      return;
+    }
+  }
+
+  // the spans of one length only read shorter spans, so each anti-diagonal 
+  //   is filled into per-span arenas that are appended in order afterwards
+  bool parallel = ( _num_threads > 1 ) && ( _words.size() >= _parallel_threshold );
+  for( unsigned int i = 0; i < _words.size(); i++ ){
+    unsigned int num_spans = _words.size() - i;
+    std::vector< std::vector< CYK_Backpointer > > backpointers( num_spans );
+    if( parallel && ( num_spans > 1 ) ){
+      std::vector< boost::thread > threads;
+      unsigned int num_threads = std::min( _num_threads, num_spans );
+      for( unsigned int j = 0; j < num_threads; j++ ){
+        threads.push_back( boost::thread( CYK_Table<T>::fill_spans_thread, this, &grammar, i, j * num_spans / num_threads, ( j + 1 ) * num_spans / num_threads, &backpointers ) );
+      }
+      for( unsigned int j = 0; j < threads.size(); j++ ){
+        threads[ j ].join();
+      }
+    } else {
+      for( unsigned int j = 0; j < num_spans; j++ ){
+        _fill_span( grammar, j, i, backpointers[ j ] );
       }
     }
+    for( unsigned int j = 0; j < num_spans; j++ ){
+      _append_backpointers( j, i, backpointers[ j ] );
+    }
   }
-  for( unsigned int i = 2; i <= _words.size(); i++ ){
-    int aj = i - 1;
-    for( int j = 1; j < ( int )( _words.size() - i + 2 ); j++ ){
-      int ai = j - 1;
-      int bi = j - 1;
-      for( unsigned int k = 1; k < i; k++ ){
-        int bj = k - 1;
-        int ci = j + k - 1;
-        int cj = i - k - 1;
-        for( unsigned int l = 0; l < grammar.non_terminals().size(); l++ ){
-          if( grammar.non_terminals()[ l ].is_cny() ){
-            int ak = _symbol_to_index( grammar.non_terminals()[ l ].a(), grammar.symbols() );
-            int bk = _symbol_to_index( grammar.non_terminals()[ l ].b(), grammar.symbols() );
-            int ck = _symbol_to_index( grammar.non_terminals()[ l ].c(), grammar.symbols() );
-            CYK_Cell& a_cell = (*this)( ai, aj, ak );
-            CYK_Cell& b_cell = (*this)( bi, bj, bk );
-            CYK_Cell& c_cell = (*this)( ci, cj, ck );
-            if( b_cell.value() && c_cell.value() ){
-              a_cell.value() = true;
-              a_cell.add_backpointer( std::make_pair< CYK_Cell*, CYK_Cell* >( &b_cell, &c_cell ) );
-            }
-            for( unsigned int m = 0; m < grammar.unit_productions().size(); m++ ){
-              int dk = _symbol_to_index( grammar.unit_productions()[ m ].symbol(), grammar.symbols() );
-              if( grammar.non_terminals()[ l ].b() == Phrase::phrase_type_t_to_std_string( grammar.unit_productions()[ m ].type() ) ){
-                if( dk > 0 ){
-                  CYK_Cell& d_cell = (*this)( bi, bj, dk );
-                  if( d_cell.value() && c_cell.value() ){
-                    a_cell.value() = true;
-                    a_cell.add_backpointer( std::make_pair< CYK_Cell*, CYK_Cell* >( &b_cell, &c_cell ) );
-                    b_cell.value() = true;
-                    b_cell.add_backpointer( std::make_pair< CYK_Cell*, CYK_Cell* >( &d_cell, NULL ) );
-                  }
-                  for( unsigned int n = 0; n < grammar.unit_productions().size(); n++ ){
-                    if( m != n ){
-                      int ek = _symbol_to_index( grammar.unit_productions()[ n ].symbol(), grammar.symbols() );
-                      if( grammar.non_terminals()[ l ].c() == Phrase::phrase_type_t_to_std_string( grammar.unit_productions()[ n ].type() ) ){
-                        if( ek > 0 ){
-                          CYK_Cell& e_cell = (*this)( ci, cj, ek );
-                          if( d_cell.value() && e_cell.value() ){
-                            a_cell.value() = true;
-                            a_cell.add_backpointer( std::make_pair< CYK_Cell*, CYK_Cell* >( &( b_cell ), &( c_cell ) ) );
-                            b_cell.value() = true;
-                            b_cell.add_backpointer( std::make_pair< CYK_Cell*, CYK_Cell* >( &( d_cell ), NULL ) );
-                            c_cell.value() = true;
-                            c_cell.add_backpointer( std::make_pair< CYK_Cell*, CYK_Cell* >( NULL, &( e_cell ) ) );
-                          }
-                        }
-                      }
-                    }
-                  }
-                }
-              } 
-              if ( grammar.non_terminals()[ l ].c() == Phrase::phrase_type_t_to_std_string( grammar.unit_productions()[ m ].type() ) ){
-                if( dk > 0 ){
-                  CYK_Cell& d_cell = (*this)( ci, cj, dk );
-                  if( b_cell.value() && d_cell.value() ){
-                    a_cell.value() = true;
-                    a_cell.add_backpointer( std::make_pair< CYK_Cell*, CYK_Cell* >( &b_cell, &c_cell ) );
-                    c_cell.value() = true;
-                    c_cell.add_backpointer( std::make_pair< CYK_Cell*, CYK_Cell* >( &d_cell, NULL ) );
-                  }
-                  for( unsigned int n = 0; n < grammar.unit_productions().size(); n++ ){
-                    if( m != n ){
-                      int ek = _symbol_to_index( grammar.unit_productions()[ n ].symbol(), grammar.symbols() );
-                      if( grammar.non_terminals()[ l ].b() == Phrase::phrase_type_t_to_std_string( grammar.unit_productions()[ n ].type() ) ){
-                        if( ek > 0 ){
-                          CYK_Cell& e_cell = (*this)( bi, bj, ek );
-                          if( e_cell.value() && d_cell.value() ){
-                            a_cell.value() = true;
-                            a_cell.add_backpointer( std::make_pair< CYK_Cell*, CYK_Cell* >( &( b_cell ), &( c_cell ) ) );
-                            b_cell.value() = true;
-                            b_cell.add_backpointer( std::make_pair< CYK_Cell*, CYK_Cell* >( &( e_cell ), NULL ) );
-                            c_cell.value() = true;
-                            c_cell.add_backpointer( std::make_pair< CYK_Cell*, CYK_Cell* >( NULL, &( d_cell ) ) );
-                          }
-                        }
-                      }
-                    }
-                  }
-                }
+  return;
+}
+
+/**
+ * appends a word to the sentence and fills only the spans that end at it, 
+ *   closing the span of the previous sentence that is now an inner span; 
+ *   the chart then matches filling the extended sentence from scratch
+ */
+template< class T >
+void
+CYK_Table<T>::
+append( const Grammar& grammar,
+        const Word& word ){
+  if( _words.size() == _capacity ){
+    _reserve( std::max< unsigned int >( 2 * _capacity, 8 ) );
+  }
+  _words.push_back( word );
+
+  unsigned int n = _words.size();
+  if( n > 1 ){
+    _close_units( grammar, 0, n - 2, _backpointers );
+    _prune( 0, n - 2 );
+  }
+
+  if( !_seed( grammar, n - 1 ) ){
+    return;
+  }
+  for( unsigned int i = 0; i < n; i++ ){
+    _fill_span( grammar, n - 1 - i, i, _backpointers );
+  }
+  return;
+}
+
+/**
+ * fills the spans of length j + 1 that start at words [ first, last ) 
+ */
+template< class T >
+void
+CYK_Table<T>::
+fill_spans_thread( CYK_Table<T>* table,
+                    const Grammar* grammar,
+                    const unsigned int j,
+                    const unsigned int first,
+                    const unsigned int last,
+                    std::vector< std::vector< CYK_Backpointer > >* backpointers ){
+  for( unsigned int i = first; i < last; i++ ){
+    table->_fill_span( *grammar, i, j, ( *backpointers )[ i ] );
+  }
+  return;
+}
+
+/**
+ * sets the terminal symbols of word i, returning false for an unknown word
+ */
+template< class T >
+bool
+CYK_Table<T>::
+_seed( const Grammar& grammar,
+        const unsigned int& i ){
+  boost::unordered_map< std::string, std::vector< std::pair< int, double > > >::const_iterator it = grammar.lexicon().find( _words[ i ].text() );
+  if( it == grammar.lexicon().end() ){
+    return false;
+  }
+  for( unsigned int j = 0; j < it->second.size(); j++ ){
+    set( i, 0, it->second[ j ].first );
+    _log_probs[ entry( i, 0, it->second[ j ].first ) ] = _probabilistic ? it->second[ j ].second : 0.0;
+  }
+  return true;
+}
+
+/**
+ * grows the chart to hold sentences of up to capacity words, moving every 
+ *   span and renumbering the entries that backpointers refer to
+ */
+template< class T >
+void
+CYK_Table<T>::
+_reserve( const unsigned int& capacity ){
+  unsigned int size = capacity * capacity * _symbols.size();
+  std::vector< uint64_t > chart( capacity * capacity * _num_blocks, 0 );
+  std::vector< int > first_backpointers( size, -1 );
+  std::vector< int > last_backpointers( size, -1 );
+  std::vector< unsigned int > num_backpointers( size, 0 );
+  std::vector< double > log_probs( size, -std::numeric_limits< double >::infinity() );
+  for( unsigned int i = 0; i < _words.size(); i++ ){
+    for( unsigned int j = 0; ( i + j ) < _words.size(); j++ ){
+      const uint64_t * span = _span( i, j );
+      std::copy( span, span + _num_blocks, &chart[ ( i * capacity + j ) * _num_blocks ] );
+      for( unsigned int k = 0; k < _symbols.size(); k++ ){
+        unsigned int e = entry( i, j, k );
+        unsigned int new_entry = ( i * capacity + j ) * _symbols.size() + k;
+        first_backpointers[ new_entry ] = _first_backpointers[ e ];
+        last_backpointers[ new_entry ] = _last_backpointers[ e ];
+        num_backpointers[ new_entry ] = _num_backpointers[ e ];
+        log_probs[ new_entry ] = _log_probs[ e ];
+      }
+    }
+  }
+
+  // entries keep their ( i, j, k ) order, so derivations compare the same
+  for( unsigned int i = 0; i < _backpointers.size(); i++ ){
+    int * children[ 2 ] = { &_backpointers[ i ].first, &_backpointers[ i ].second };
+    for( unsigned int j = 0; j < 2; j++ ){
+      if( *children[ j ] >= 0 ){
+        unsigned int span = *children[ j ] / _symbols.size();
+        *children[ j ] = ( ( span / _capacity ) * capacity + span % _capacity ) * _symbols.size() + *children[ j ] % _symbols.size();
+      }
+    }
+  }
+
+  _capacity = capacity;
+  _chart.swap( chart );
+  _first_backpointers.swap( first_backpointers );
+  _last_backpointers.swap( last_backpointers );
+  _num_backpointers.swap( num_backpointers );
+  _log_probs.swap( log_probs );
+  return;
+}
+
+/**
+ * fills span ( i, j ) from the shorter spans, adding its backpointers to an 
+ *   arena of its own
+ */
+template< class T >
+void
+CYK_Table<T>::
+_fill_span( const Grammar& grammar,
+            const unsigned int& i,
+            const unsigned int& j,
+            std::vector< CYK_Backpointer >& backpointers ){
+  const std::vector< Grammar_Binary_Rule >& binary_rules = grammar.binary_rules();
+  std::vector< unsigned int > rules;
+  for( unsigned int k = 0; k < j; k++ ){
+    unsigned int ci = i + k + 1;
+    unsigned int cj = j - k - 1;
+    // the right symbols of each left symbol are matched a word of the span at a time; only 
+    //   the rules of the matched pairs are applied, in the order of the grammar so that 
+    //   derivations compare the same
+    const uint64_t * left = _span( i, k );
+    const uint64_t * right = _span( ci, cj );
+    rules.clear();
+    for( unsigned int l = 0; l < _num_blocks; l++ ){
+      uint64_t left_block = left[ l ];
+      for( unsigned int b = l * 64; left_block != 0; b++, left_block >>= 1 ){
+        if( !( left_block & 1 ) ){
+          continue;
+        }
+        const std::vector< std::pair< int, std::vector< unsigned int > > >& rule_pairs = grammar.binary_rule_pairs()[ b ];
+        unsigned int pair_index = 0;
+        for( unsigned int m = 0; m < _num_blocks; m++ ){
+          uint64_t right_block = grammar.binary_pair_masks()[ b * _num_blocks + m ] & right[ m ];
+          for( int c = m * 64; right_block != 0; c++, right_block >>= 1 ){
+            if( right_block & 1 ){
+              while( rule_pairs[ pair_index ].first < c ){
+                pair_index++;
               }
+              rules.insert( rules.end(), rule_pairs[ pair_index ].second.begin(), rule_pairs[ pair_index ].second.end() );
             }
           }
         }
       }
     }
-  } 
+    std::sort( rules.begin(), rules.end() );
+    for( unsigned int l = 0; l < rules.size(); l++ ){
+      const Grammar_Binary_Rule& rule = binary_rules[ rules[ l ] ];
+      set( i, j, rule.a );
+      _add_backpointer( backpointers, entry( i, j, rule.a ), entry( i, k, rule.b ), entry( ci, cj, rule.c ), rules[ l ], _probabilistic ? rule.log_prob : 0.0 );
+    }
+  }
+  // the span of the whole sentence is left as the binary rules built it
+  if( j < ( _words.size() - 1 ) ){
+    _close_units( grammar, i, j, backpointers );
+    _prune( i, j );
+  }
+  return;
+}
+
+template< class T >
+void
+CYK_Table<T>::
+_add_backpointer( std::vector< CYK_Backpointer >& backpointers,
+                  const unsigned int& entry,
+                  const int& first,
+                  const int& second,
+                  const int& rule,
+                  const double& logProb ){
+  for( int i = _first_backpointers[ entry ]; i >= 0; i = backpointers[ i ].next ){
+    if( ( ( backpointers[ i ].first == first ) && ( backpointers[ i ].second == second ) ) || ( ( backpointers[ i ].second == first ) && ( backpointers[ i ].first == second ) ) ){
+      return;
+    }
+  }
+  backpointers.push_back( CYK_Backpointer( first, second, rule, logProb, _num_backpointers[ entry ] ) );
+  if( _last_backpointers[ entry ] >= 0 ){
+    backpointers[ _last_backpointers[ entry ] ].next = backpointers.size() - 1;
+  } else {
+    _first_backpointers[ entry ] = backpointers.size() - 1;
+  }
+  _last_backpointers[ entry ] = backpointers.size() - 1;
+  _num_backpointers[ entry ]++;
+
+  double log_prob = logProb;
+  if( first >= 0 ){
+    log_prob += _log_probs[ first ];
+  }
+  if( second >= 0 ){
+    log_prob += _log_probs[ second ];
+  }
+  _log_probs[ entry ] = std::max( _log_probs[ entry ], log_prob );
+  return;
+}
+
+/**
+ * moves the backpointers of span ( i, j ) from its own arena to the end of 
+ *   the table's arena
+ */
+template< class T >
+void
+CYK_Table<T>::
+_append_backpointers( const unsigned int& i,
+                      const unsigned int& j,
+                      std::vector< CYK_Backpointer >& backpointers ){
+  int offset = _backpointers.size();
+  for( unsigned int k = 0; k < _symbols.size(); k++ ){
+    unsigned int e = entry( i, j, k );
+    if( _first_backpointers[ e ] >= 0 ){
+      _first_backpointers[ e ] += offset;
+      _last_backpointers[ e ] += offset;
+    }
+  }
+  for( unsigned int k = 0; k < backpointers.size(); k++ ){
+    if( backpointers[ k ].next >= 0 ){
+      backpointers[ k ].next += offset;
+    }
+    _backpointers.push_back( backpointers[ k ] );
+  }
+  backpointers.clear();
+  return;
+}
+/**
+ * adds every symbol reachable through unit productions from the symbols of a 
+ *   span, with a backpointer for each unit production that applies
+ */
+template< class T >
+void
+CYK_Table<T>::
+_close_units( const Grammar& grammar,
+              const unsigned int& i,
+              const unsigned int& j,
+              std::vector< CYK_Backpointer >& backpointers ){
+  uint64_t * span = _span( i, j );
+  std::vector< uint64_t > closed( span, span + _num_blocks );
+  for( unsigned int k = 0; k < _symbols.size(); k++ ){
+    if( ( span[ k / 64 ] >> ( k % 64 ) ) & 1 ){
+      for( unsigned int l = 0; l < _num_blocks; l++ ){
+        closed[ l ] |= grammar.unit_closure_masks()[ k * _num_blocks + l ];
+      }
+    }
+  }
+  for( unsigned int k = 0; k < _num_blocks; k++ ){
+    span[ k ] = closed[ k ];
+  }
+
+  // unit productions that close a cycle are not followed
+  std::vector< unsigned int > units;
+  for( unsigned int k = 0; k < grammar.unit_productions().size(); k++ ){
+    int type = grammar.unit_types()[ k ];
+    int symbol = grammar.unit_symbols()[ k ];
+    if( ( type >= 0 ) && ( symbol >= 0 ) && (*this)( i, j, symbol ) && !grammar.unit_closures()[ type ][ symbol ] ){
+      _add_backpointer( backpointers, entry( i, j, type ), entry( i, j, symbol ), -1, k, _probabilistic ? grammar.unit_log_probs()[ k ] : 0.0 );
+      units.push_back( k );
+    }
+  }
+
+  // propagate the log probabilities along chains of unit productions
+  for( unsigned int k = 0; k < units.size(); k++ ){
+    bool changed = false;
+    for( unsigned int l = 0; l < units.size(); l++ ){
+      double log_prob = ( _probabilistic ? grammar.unit_log_probs()[ units[ l ] ] : 0.0 ) + _log_probs[ entry( i, j, grammar.unit_symbols()[ units[ l ] ] ) ];
+      double& type_log_prob = _log_probs[ entry( i, j, grammar.unit_types()[ units[ l ] ] ) ];
+      if( log_prob > type_log_prob ){
+        type_log_prob = log_prob;
+        changed = true;
+      }
+    }
+    if( !changed ){
+      break;
+    }
+  }
+  return;
+}
+
+/**
+ * keeps the beamWidth most probable symbols of a span
+ */
+template< class T >
+void
+CYK_Table<T>::
+_prune( const unsigned int& i,
+        const unsigned int& j ){
+  if( !_probabilistic || ( _beam_width == 0 ) ){
+    return;
+  }
+  std::vector< std::pair< double, unsigned int > > symbols;
+  for( unsigned int k = 0; k < _symbols.size(); k++ ){
+    if( (*this)( i, j, k ) ){
+      symbols.push_back( std::pair< double, unsigned int >( -_log_probs[ entry( i, j, k ) ], k ) );
+    }
+  }
+  if( symbols.size() > _beam_width ){
+    std::sort( symbols.begin(), symbols.end() );
+    uint64_t * span = _span( i, j );
+    for( unsigned int k = _beam_width; k < symbols.size(); k++ ){
+      span[ symbols[ k ].second / 64 ] &= ~( ( uint64_t )( 1 ) << ( symbols[ k ].second % 64 ) );
+    }
+  }
   return;
 }
 
@@ -199,7 +474,8 @@ template< class T >
 void
 CYK_Table<T>::
 parse( const Grammar& grammar,
-        std::vector< T* >& phrases ){
+        std::vector< T* >& phrases,
+        const unsigned int& maxParses ){
   for( unsigned int i = 0; i < phrases.size(); i++ ){
     if( phrases[ i ] != NULL ){
       delete phrases[ i ];
@@ -208,188 +484,311 @@ parse( const Grammar& grammar,
   }
   phrases.clear();
 
-  std::vector< std::vector< unsigned int > > indices;
-  std::vector< std::vector< unsigned int > > sets;
-  for( unsigned int i = 0; i < _words.size(); i++ ){
-    for( unsigned int j = 0; j < _words.size(); j++ ){
-      for( unsigned int k = 0; k < _symbols.size(); k++ ){
-        if( !(*this)( i, j, k ).backpointers().empty() ){
-          indices.push_back( std::vector< unsigned int >( 3 ) );
-          indices.back()[ 0 ] = i;
-          indices.back()[ 1 ] = j;
-          indices.back()[ 2 ] = k;
-          sets.push_back( std::vector< unsigned int >( (*this)( i, j, k ).backpointers().size() ) );
-          for( unsigned int l = 0; l < sets.back().size(); l++ ){
-            sets.back()[ l ] = l;
-          }
-        }
-      }
-    }
+  if( _words.empty() ){
+    return;
   }
-  std::vector< std::vector< unsigned int > > power_sets = cartesian_power( sets );
-  for( unsigned int i = 0; i < power_sets.size(); i++ ){
-    CYK_Table * tmp = new CYK_Table( _words, _symbols );
-    for( unsigned int j = 0; j < _words.size(); j++ ){
-      for( unsigned int k = 0; k < _words.size(); k++ ){
-        for( unsigned int l = 0; l < _symbols.size(); l++ ){
-          const CYK_Cell& this_cell = (*this)( j, k, l );
-          CYK_Cell& tmp_cell = (*tmp)( j, k, l );
-          for( unsigned int m = 0; m < indices.size(); m++ ){
-            if( ( indices[ m ][ 0 ] == j ) && ( indices[ m ][ 1 ] == k ) && ( indices[ m ][ 2 ] == l ) ){
-              tmp_cell.value() = true;
-              std::vector< unsigned int > first_index, second_index;
-              tmp_cell.backpointers().push_back( std::pair< CYK_Cell*, CYK_Cell* >() );
-              if( _find_index( this_cell.backpointers()[ power_sets[ i ][ m ] ].first, first_index ) ){
-                tmp_cell.backpointers().back().first = &( (*tmp)( first_index[ 0 ], first_index[ 1 ], first_index[ 2 ] ) );
-              }
-              if( _find_index( this_cell.backpointers()[ power_sets[ i ][ m ] ].second, second_index ) ){
-                tmp_cell.backpointers().back().second = &( (*tmp)( second_index[ 0 ], second_index[ 1 ], second_index[ 2 ] ) );
-              }
-            }
-          }
-        }
-      }
-    }
 
-    
+  std::vector< unsigned int > roots;
+  _initialize_derivations( roots );
+  std::vector< unsigned int > ranks( roots.size(), 0 );
 
-    for( unsigned int j = 0; j < tmp->symbols().size(); j++ ){
-      if( (*tmp)( 0, tmp->words().size() - 1, j ).value() ){
-        phrases.push_back( new T() );
-        tmp->traverse( grammar, phrases.back(), &( (*tmp)( 0, tmp->words().size() - 1, j ) ) );
-    
-        bool new_phrase = true; 
-        for( unsigned int j = 0; j < ( phrases.size() - 1 ); j++ ){
-          if( *phrases.back() == *phrases[ j ] ){
-            new_phrase = false;
-            j = phrases.size();
-          }
-        }
-        if( !new_phrase ){
-          delete phrases.back();
-          phrases.pop_back();
-        } 
-      }
+  std::set< std::string > keys;
+  while( ( maxParses == 0 ) || ( phrases.size() < maxParses ) ){
+    int root = _next_root( roots, ranks );
+    if( root < 0 ){
+      break;
     }
-    if( tmp != NULL ){
-      delete tmp;
-      tmp = NULL;
+
+    phrases.push_back( new T() );
+    traverse( grammar, phrases.back(), roots[ root ], ranks[ root ] );
+    ranks[ root ]++;
+    if( !keys.insert( _phrase_key( phrases.back() ) ).second ){
+      delete phrases.back();
+      phrases.pop_back();
     }
   }
 
   return;
 }
 
+/**
+ * finds the derivation of the sentence that yields the same tree as phrase 
+ *   and adds the rules it uses to the counts, returning false if there is none
+ */
+template< class T >
+bool
+CYK_Table<T>::
+count_rules( const Grammar& grammar,
+              const T* phrase,
+              std::vector< double >& binaryRuleCounts,
+              std::vector< double >& unitProductionCounts ){
+  if( _words.empty() ){
+    return false;
+  }
+
+  std::vector< unsigned int > roots;
+  _initialize_derivations( roots );
+  std::vector< unsigned int > ranks( roots.size(), 0 );
+
+  std::string key = _phrase_key( phrase, false );
+  while( true ){
+    int root = _next_root( roots, ranks );
+    if( root < 0 ){
+      return false;
+    }
+
+    T * tmp = new T();
+    traverse( grammar, tmp, roots[ root ], ranks[ root ] );
+    bool match = ( _phrase_key( tmp, false ) == key );
+    delete tmp;
+    if( match ){
+      _count_rules( roots[ root ], ranks[ root ], binaryRuleCounts, unitProductionCounts );
+      return true;
+    }
+    ranks[ root ]++;
+  }
+  return false;
+}
+
 template< class T >
 void
 CYK_Table<T>::
 traverse( const Grammar& grammar, 
           T* phrase,
-          CYK_Cell* root )const{
-  if( root ){
-    std::vector< unsigned int > root_index, first_index, second_index;
-    if( _find_index( root, root_index ) ){
-      for( unsigned int i = 0; i < NUM_PHRASE_TYPES; i++ ){
-        if( Phrase::phrase_type_t_to_std_string( ( phrase_type_t )( i ) ) == _symbols[ root_index[ 2 ] ] ){
-          phrase->type() = ( phrase_type_t )( i );
-        }
-      }
+          const unsigned int& entry,
+          const unsigned int& rank )const{
+  unsigned int symbol = entry_symbol( entry );
+  if( _symbol_phrase_types[ symbol ] >= 0 ){
+    phrase->type() = ( phrase_type_t )( _symbol_phrase_types[ symbol ] );
+  }
 
-      const CYK_Cell& root_cell = (*this)( root_index[ 0 ], root_index[ 1 ], root_index[ 2 ] );
-      if( root_cell.backpointers().size() == 1 ){
-        if( _find_index( root_cell.backpointers()[ 0 ].first, first_index ) ){
-          for( unsigned int l = 0; l < NUM_POS_TAGS; l++ ){
-            if( pos_t_to_std_string( ( pos_t )( l ) ) == _symbols[ first_index[ 2 ] ] ){
-              phrase->words().push_back( _words[ first_index[ 0 ] ] );
-              phrase->words().back().pos() = ( pos_t )( l );
-            }
-          }
-          for( unsigned int l = 0; l < NUM_PHRASE_TYPES; l++ ){
-            if( Phrase::phrase_type_t_to_std_string( ( phrase_type_t )( l ) ) == _symbols[ first_index[ 2 ] ] ){
-              phrase->children().push_back( new T() );
-              traverse( grammar, dynamic_cast< T* >( phrase->children().back() ), root_cell.backpointers()[ 0 ].first );
-            }
-          }
-          for( unsigned int l = 0; l < NUM_PHRASE_PLACEHOLDERS; l++ ){
-            if( Grammar::grammar_placeholder_t_to_std_string( ( grammar_placeholder_t )( l ) ) == _symbols[ first_index[ 2 ] ] ){
-              traverse( grammar, phrase, root_cell.backpointers()[ 0 ].first );
-            }
-          }
+  const CYK_Derivation& derivation = _derivations[ entry ][ rank ];
+  if( derivation.backpointer >= 0 ){
+    const CYK_Backpointer& backpointer = _backpointers[ derivation.backpointer ];
+    int children[ 2 ] = { backpointer.first, backpointer.second };
+    unsigned int child_ranks[ 2 ] = { derivation.first_rank, derivation.second_rank };
+    for( unsigned int i = 0; i < 2; i++ ){
+      if( children[ i ] >= 0 ){
+        unsigned int child_symbol = entry_symbol( children[ i ] );
+        if( _symbol_pos_tags[ child_symbol ] >= 0 ){
+          phrase->words().push_back( _words[ entry_start( children[ i ] ) ] );
+          phrase->words().back().pos() = ( pos_t )( _symbol_pos_tags[ child_symbol ] );
         }
-        if( _find_index( root_cell.backpointers()[ 0 ].second, second_index ) ){
-          for( unsigned int l = 0; l < NUM_POS_TAGS; l++ ){
-            if( pos_t_to_std_string( ( pos_t )( l ) ) == _symbols[ second_index[ 2 ] ] ){
-              phrase->words().push_back( _words[ second_index[ 0 ] ] );
-              phrase->words().back().pos() = ( pos_t )( l );
-            }
-          }
-          for( unsigned int l = 0; l < NUM_PHRASE_TYPES; l++ ){
-            if( Phrase::phrase_type_t_to_std_string( ( phrase_type_t )( l ) ) == _symbols[ second_index[ 2 ] ] ){
-              phrase->children().push_back( new T() );
-              traverse( grammar, dynamic_cast< T* >( phrase->children().back() ), root_cell.backpointers()[ 0 ].second );
-            }
-          }
-          for( unsigned int l = 0; l < NUM_PHRASE_PLACEHOLDERS; l++ ){
-            if( Grammar::grammar_placeholder_t_to_std_string( ( grammar_placeholder_t )( l ) ) == _symbols[ second_index[ 2 ] ] ){
-              traverse( grammar, phrase, root_cell.backpointers()[ 0 ].second );
-            }
-          }
+        if( _symbol_phrase_types[ child_symbol ] >= 0 ){
+          phrase->children().push_back( new T() );
+          traverse( grammar, dynamic_cast< T* >( phrase->children().back() ), children[ i ], child_ranks[ i ] );
         }
+        if( _symbol_placeholders[ child_symbol ] ){
+          traverse( grammar, phrase, children[ i ], child_ranks[ i ] );
+        }
+      }
+    }
+  } else {
+    assert( false );
+  }
+  return;
+}
+
+template< class T >
+void
+CYK_Table<T>::
+_initialize_derivations( std::vector< unsigned int >& roots ){
+  _derivations.clear();
+  _derivations.resize( _first_backpointers.size() );
+  _candidates.clear();
+  _candidates.resize( _first_backpointers.size() );
+  _candidate_keys.clear();
+  _candidate_keys.resize( _first_backpointers.size() );
+  _derivations_initialized.assign( _first_backpointers.size(), false );
+
+  roots.clear();
+  for( unsigned int i = 0; i < _symbols.size(); i++ ){
+    if( _first_backpointers[ entry( 0, _words.size() - 1, i ) ] >= 0 ){
+      roots.push_back( entry( 0, _words.size() - 1, i ) );
+    }
+  }
+  return;
+}
+
+/**
+ * returns the index of the root whose next derivation comes first, or -1 if 
+ *   every root is out of derivations
+ */
+template< class T >
+int
+CYK_Table<T>::
+_next_root( const std::vector< unsigned int >& roots,
+            const std::vector< unsigned int >& ranks ){
+  int min_root = -1;
+  for( unsigned int i = 0; i < roots.size(); i++ ){
+    if( _kth_derivation( roots[ i ], ranks[ i ] ) ){
+      if( ( min_root < 0 ) || ( _derivations[ roots[ i ] ][ ranks[ i ] ] < _derivations[ roots[ min_root ] ][ ranks[ min_root ] ] ) ){
+        min_root = i;
+      }
+    }
+  }
+  return min_root;
+}
+
+template< class T >
+void
+CYK_Table<T>::
+_count_rules( const unsigned int& entry,
+              const unsigned int& rank,
+              std::vector< double >& binaryRuleCounts,
+              std::vector< double >& unitProductionCounts )const{
+  const CYK_Derivation& derivation = _derivations[ entry ][ rank ];
+  if( derivation.backpointer >= 0 ){
+    const CYK_Backpointer& backpointer = _backpointers[ derivation.backpointer ];
+    if( backpointer.rule >= 0 ){
+      if( backpointer.second >= 0 ){
+        binaryRuleCounts[ backpointer.rule ] += 1.0;
       } else {
-        assert( false );
+        unitProductionCounts[ backpointer.rule ] += 1.0;
       }
     }
+    if( _expands( backpointer.first ) ){
+      _count_rules( backpointer.first, derivation.first_rank, binaryRuleCounts, unitProductionCounts );
+    }
+    if( _expands( backpointer.second ) ){
+      _count_rules( backpointer.second, derivation.second_rank, binaryRuleCounts, unitProductionCounts );
+    }
   }
   return;
 }
 
 template< class T >
-std::string
+bool
 CYK_Table<T>::
-_symbol_from_index( const unsigned int& index,
-                    const std::vector< std::string >& symbols ){
-  if( index < symbols.size() ){
-    return symbols[ index ];
+_expands( const int& entry )const{
+  if( entry >= 0 ){
+    unsigned int symbol = entry_symbol( entry );
+    return ( _symbol_phrase_types[ symbol ] >= 0 ) || _symbol_placeholders[ symbol ];
   } else {
-    return "NA";
+    return false;
   }
-  return symbols[ index ];
 }
 
+/**
+ * extends the sorted derivations of an entry until it has more than k of 
+ *   them, returning false if the entry has k or fewer derivations in total
+ */
 template< class T >
 bool
 CYK_Table<T>::
-_find_index( const CYK_Cell* cell,
-              std::vector< unsigned int >& index )const{
-  if( cell != NULL ){
-    for( unsigned int i = 0; i < _words.size(); i++ ){
-      for( unsigned int j = 0; j < _words.size(); j++ ){
-        for( unsigned int k = 0; k < _symbols.size(); k++ ){
-          if( cell == &( _cells[ i ][ j ][ k ] ) ){
-            index.resize( 3 );
-            index[ 0 ] = i;
-            index[ 1 ] = j;
-            index[ 2 ] = k;
-            return true;
-          }
-        }
+_kth_derivation( const unsigned int& entry,
+                  const unsigned int& k ){
+  if( !_derivations_initialized[ entry ] ){
+    _derivations_initialized[ entry ] = true;
+    if( _first_backpointers[ entry ] < 0 ){
+      _derivations[ entry ].push_back( CYK_Derivation( -1, 0, 0, _log_probs[ entry ] ) );
+    } else {
+      for( int i = _first_backpointers[ entry ]; i >= 0; i = _backpointers[ i ].next ){
+        _push_candidate( entry, i, 0, 0 );
       }
     }
   }
-  return false;
+  while( _derivations[ entry ].size() <= k ){
+    if( !_derivations[ entry ].empty() ){
+      _next_derivations( entry, _derivations[ entry ].back() );
+    }
+    if( _candidates[ entry ].empty() ){
+      break;
+    }
+    _derivations[ entry ].push_back( _candidates[ entry ].top() );
+    _candidates[ entry ].pop();
+  }
+  return _derivations[ entry ].size() > k;
 }
 
 template< class T >
-int
+void
 CYK_Table<T>::
-_symbol_to_index( const std::string& symbol,
-                  const std::vector< std::string >& symbols ){
-  for( unsigned int i = 0; i < symbols.size(); i++ ){
-    if( symbol == symbols[ i ] ){
-      return i;
+_next_derivations( const unsigned int& entry,
+                    const CYK_Derivation& derivation ){
+  if( derivation.backpointer >= 0 ){
+    CYK_Derivation tmp = derivation;
+    const CYK_Backpointer& backpointer = _backpointers[ tmp.backpointer ];
+    if( _expands( backpointer.first ) && _kth_derivation( backpointer.first, tmp.first_rank + 1 ) ){
+      _push_candidate( entry, tmp.backpointer, tmp.first_rank + 1, tmp.second_rank );
+    }
+    if( _expands( backpointer.second ) && _kth_derivation( backpointer.second, tmp.second_rank + 1 ) ){
+      _push_candidate( entry, tmp.backpointer, tmp.first_rank, tmp.second_rank + 1 );
     }
   }
-  return -1;
+  return;
+}
+
+template< class T >
+void
+CYK_Table<T>::
+_push_candidate( const unsigned int& entry,
+                  const int& backpointer,
+                  const unsigned int& firstRank,
+                  const unsigned int& secondRank ){
+  if( !_candidate_keys[ entry ].insert( std::make_pair( backpointer, std::make_pair( firstRank, secondRank ) ) ).second ){
+    return;
+  }
+  CYK_Derivation derivation( backpointer, firstRank, secondRank, _backpointers[ backpointer ].log_prob );
+  const CYK_Backpointer& tmp = _backpointers[ backpointer ];
+  if( tmp.rank > 0 ){
+    derivation.choices.push_back( std::make_pair( entry, tmp.rank ) );
+  }
+  if( _expands( tmp.first ) && _kth_derivation( tmp.first, firstRank ) ){
+    const CYK_Derivation& child = _derivations[ tmp.first ][ firstRank ];
+    derivation.log_prob += child.log_prob;
+    derivation.choices.insert( derivation.choices.end(), child.choices.begin(), child.choices.end() );
+  } else if( tmp.first >= 0 ){
+    derivation.log_prob += _log_probs[ tmp.first ];
+  }
+  if( _expands( tmp.second ) && _kth_derivation( tmp.second, secondRank ) ){
+    const CYK_Derivation& child = _derivations[ tmp.second ][ secondRank ];
+    derivation.log_prob += child.log_prob;
+    derivation.choices.insert( derivation.choices.end(), child.choices.begin(), child.choices.end() );
+  } else if( tmp.second >= 0 ){
+    derivation.log_prob += _log_probs[ tmp.second ];
+  }
+  std::sort( derivation.choices.begin(), derivation.choices.end() );
+  _candidates[ entry ].push( derivation );
+  return;
+}
+
+/**
+ * a string that is equal for two phrases exactly when Phrase::operator== is, 
+ *   or when it would be if it ignored the text of the phrases
+ */
+template< class T >
+std::string
+CYK_Table<T>::
+_phrase_key( const Phrase* phrase,
+              const bool& text )const{
+  std::stringstream key;
+  key << phrase->type() << "|";
+  if( text ){
+    key << phrase->text().size() << " " << phrase->text();
+  }
+  key << "|" << phrase->words().size() << "|";
+  for( unsigned int i = 0; i < phrase->words().size(); i++ ){
+    key << phrase->words()[ i ].pos() << " " << phrase->words()[ i ].text().size() << " " << phrase->words()[ i ].text() << "|";
+  }
+  key << phrase->children().size();
+  for( unsigned int i = 0; i < phrase->children().size(); i++ ){
+    key << "(" << _phrase_key( phrase->children()[ i ], text ) << ")";
+  }
+  return key.str();
+}
+
+template< class T >
+std::string
+CYK_Table<T>::
+_symbol_from_index( const unsigned int& index,
+                    const std::vector< std::string >& symbols ){
+  if( index < symbols.size() ){
+    return symbols[ index ];
+  } else {
+    return "NA";
+  }
+  return symbols[ index ];
 }
 
 template< class T >
@@ -400,11 +799,11 @@ operator<<( std::ostream& out,
     for( unsigned int j = 0; j < other.words().size(); j++ ){
       std::stringstream table_string;
       for( unsigned int k = 0; k < other.symbols().size(); k++ ){
-        if( other( j, i, k ).value() ){
+        if( other( j, i, k ) ){
           if( !table_string.str().empty() ){
             table_string << "/";
           }
-          table_string << other( j, i, k ).backpointers().size();
+          table_string << other.num_backpointers( other.entry( j, i, k ) );
         }
       }
       out << std::setw( 10 ) << table_string.str();
@@ -419,7 +818,7 @@ operator<<( std::ostream& out,
     for( unsigned int j = 0; j < other.words().size(); j++ ){
       std::stringstream table_string;
       for( unsigned int k = 0; k < other.symbols().size(); k++ ){
-        if( other( j, i, k ).value() ){
+        if( other( j, i, k ) ){
           if( !table_string.str().empty() ){
             table_string << "/";
           }
@@ -439,7 +838,16 @@ operator<<( std::ostream& out,
 
 template< class T >
 Parser_CYK<T>::
-Parser_CYK() {
+Parser_CYK( const unsigned int& maxParses,
+            const bool& probabilistic,
+            const unsigned int& beamWidth,
+            const unsigned int& numThreads,
+            const unsigned int& parallelThreshold ) : Parser<T>(),
+                                              _max_parses( maxParses ),
+                                              _probabilistic( probabilistic ),
+                                              _beam_width( beamWidth ),
+                                              _num_threads( numThreads ),
+                                              _parallel_threshold( parallelThreshold ) {
 
 }
 
@@ -451,7 +859,12 @@ Parser_CYK<T>::
 
 template< class T >
 Parser_CYK<T>::
-Parser_CYK( const Parser_CYK<T>& other ) {
+Parser_CYK( const Parser_CYK<T>& other ) : Parser<T>( other ),
+                                            _max_parses( other._max_parses ),
+                                            _probabilistic( other._probabilistic ),
+                                            _beam_width( other._beam_width ),
+                                            _num_threads( other._num_threads ),
+                                            _parallel_threshold( other._parallel_threshold ) {
 
 }
 
@@ -459,7 +872,11 @@ template< class T >
 Parser_CYK<T>&
 Parser_CYK<T>::
 operator=( const Parser_CYK<T>& other ) {
-
+  _max_parses = other._max_parses;
+  _probabilistic = other._probabilistic;
+  _beam_width = other._beam_width;
+  _num_threads = other._num_threads;
+  _parallel_threshold = other._parallel_threshold;
   return (*this);
 }
 
@@ -473,10 +890,10 @@ parse( const Grammar& grammar,
   std::vector< Word > words;
   this->_text_to_words( text, words );
 
-  CYK_Table<T> * cyk_table = new CYK_Table<T>( words, grammar.symbols() );
+  CYK_Table<T> * cyk_table = new CYK_Table<T>( words, grammar.symbols(), _probabilistic, _beam_width, _num_threads, _parallel_threshold );
 
   cyk_table->fill( grammar );
-  cyk_table->parse( grammar, phrases );
+  cyk_table->parse( grammar, phrases, _max_parses );
 
   if( debug ){
     if( cyk_table != NULL ){
@@ -492,6 +909,96 @@ parse( const Grammar& grammar,
   return !phrases.empty();
 }
 
+/**
+ * estimates the probabilities of the grammar's binary rules, unit productions 
+ *   and terminal words from the annotated phrases of ( instruction, phrase ) 
+ *   examples with add-one smoothing, using the derivation of each instruction 
+ *   that yields its annotated phrase; returns the number of examples used
+ */
+template< class T >
+unsigned int
+Parser_CYK<T>::
+estimate( Grammar& grammar,
+          const std::vector< std::pair< std::string, const T* > >& examples )const{
+  std::vector< double > binary_rule_counts( grammar.binary_rules().size(), 0.0 );
+  std::vector< double > unit_production_counts( grammar.unit_productions().size(), 0.0 );
+  std::vector< std::vector< double > > terminal_counts( grammar.terminals().size() );
+  for( unsigned int i = 0; i < grammar.terminals().size(); i++ ){
+    terminal_counts[ i ].resize( grammar.terminals()[ i ].words().size(), 0.0 );
+  }
+
+  unsigned int num_examples = 0;
+  for( unsigned int i = 0; i < examples.size(); i++ ){
+    std::vector< Word > words;
+    this->_text_to_words( examples[ i ].first, words );
+    CYK_Table<T> cyk_table( words, grammar.symbols() );
+    cyk_table.fill( grammar );
+    if( cyk_table.count_rules( grammar, examples[ i ].second, binary_rule_counts, unit_production_counts ) ){
+      _count_words( grammar, examples[ i ].second, terminal_counts );
+      num_examples++;
+    }
+  }
+
+  std::map< std::string, double > totals;
+  unsigned int binary_rule_index = 0;
+  for( unsigned int i = 0; i < grammar.non_terminals().size(); i++ ){
+    if( grammar.non_terminals()[ i ].is_cny() ){
+      totals[ grammar.non_terminals()[ i ].a() ] += binary_rule_counts[ binary_rule_index ] + 1.0;
+      binary_rule_index++;
+    }
+  }
+  for( unsigned int i = 0; i < grammar.unit_productions().size(); i++ ){
+    totals[ Phrase::phrase_type_t_to_std_string( grammar.unit_productions()[ i ].type() ) ] += unit_production_counts[ i ] + 1.0;
+  }
+
+  binary_rule_index = 0;
+  for( unsigned int i = 0; i < grammar.non_terminals().size(); i++ ){
+    if( grammar.non_terminals()[ i ].is_cny() ){
+      grammar.non_terminals()[ i ].prob() = ( binary_rule_counts[ binary_rule_index ] + 1.0 ) / totals[ grammar.non_terminals()[ i ].a() ];
+      binary_rule_index++;
+    }
+  }
+  for( unsigned int i = 0; i < grammar.unit_productions().size(); i++ ){
+    grammar.unit_productions()[ i ].prob() = ( unit_production_counts[ i ] + 1.0 ) / totals[ Phrase::phrase_type_t_to_std_string( grammar.unit_productions()[ i ].type() ) ];
+  }
+  for( unsigned int i = 0; i < grammar.terminals().size(); i++ ){
+    double total = 0.0;
+    for( unsigned int j = 0; j < terminal_counts[ i ].size(); j++ ){
+      total += terminal_counts[ i ][ j ] + 1.0;
+    }
+    grammar.terminals()[ i ].probs().resize( terminal_counts[ i ].size() );
+    for( unsigned int j = 0; j < terminal_counts[ i ].size(); j++ ){
+      grammar.terminals()[ i ].probs()[ j ] = ( terminal_counts[ i ][ j ] + 1.0 ) / total;
+    }
+  }
+  grammar.compile();
+
+  return num_examples;
+}
+
+template< class T >
+void
+Parser_CYK<T>::
+_count_words( const Grammar& grammar,
+              const Phrase* phrase,
+              std::vector< std::vector< double > >& terminalCounts )const{
+  for( unsigned int i = 0; i < phrase->words().size(); i++ ){
+    for( unsigned int j = 0; j < grammar.terminals().size(); j++ ){
+      if( grammar.terminals()[ j ].symbol() == pos_t_to_std_string( phrase->words()[ i ].pos() ) ){
+        for( unsigned int k = 0; k < grammar.terminals()[ j ].words().size(); k++ ){
+          if( grammar.terminals()[ j ].words()[ k ] == phrase->words()[ i ].text() ){
+            terminalCounts[ j ][ k ] += 1.0;
+          }
+        }
+      }
+    }
+  }
+  for( unsigned int i = 0; i < phrase->children().size(); i++ ){
+    _count_words( grammar, phrase->children()[ i ], terminalCounts );
+  }
+  return;
+}
+
 template< class T >
 std::ostream&
 operator<<( std::ostream& out,
@@ -499,3 +1006,88 @@ operator<<( std::ostream& out,
   return out;
 }
 
+template< class T >
+CYK_Session<T>::
+CYK_Session( const Grammar& grammar,
+              const Parser_CYK<T>& parser ) : _grammar( &grammar ),
+                                              _parser( parser ),
+                                              _cyk_table( NULL ) {
+  clear();
+}
+
+template< class T >
+CYK_Session<T>::
+~CYK_Session() {
+  if( _cyk_table != NULL ){
+    delete _cyk_table;
+    _cyk_table = NULL;
+  }
+}
+
+template< class T >
+CYK_Session<T>::
+CYK_Session( const CYK_Session<T>& other ) : _grammar( other._grammar ),
+                                              _parser( other._parser ),
+                                              _cyk_table( new CYK_Table<T>( *other._cyk_table ) ) {
+
+}
+
+template< class T >
+CYK_Session<T>&
+CYK_Session<T>::
+operator=( const CYK_Session<T>& other ) {
+  if( this != &other ){
+    _grammar = other._grammar;
+    _parser = other._parser;
+    if( _cyk_table != NULL ){
+      delete _cyk_table;
+    }
+    _cyk_table = new CYK_Table<T>( *other._cyk_table );
+  }
+  return (*this);
+}
+
+/**
+ * appends the words of text, normalized as Parser_CYK::parse does
+ */
+template< class T >
+void
+CYK_Session<T>::
+append( const std::string& text ){
+  std::vector< Word > words;
+  _parser._text_to_words( text, words );
+  for( unsigned int i = 0; i < words.size(); i++ ){
+    _cyk_table->append( *_grammar, Word( words[ i ].pos(), words[ i ].text(), _cyk_table->words().size() ) );
+  }
+  return;
+}
+
+/**
+ * the complete parses of the words appended so far
+ */
+template< class T >
+bool
+CYK_Session<T>::
+parses( std::vector< T* >& phrases ){
+  _cyk_table->parse( *_grammar, phrases, _parser.max_parses() );
+  return !phrases.empty();
+}
+
+template< class T >
+void
+CYK_Session<T>::
+clear( void ){
+  if( _cyk_table != NULL ){
+    delete _cyk_table;
+  }
+  _cyk_table = new CYK_Table<T>( std::vector< Word >(), _grammar->symbols(), _parser.probabilistic(), _parser.beam_width() );
+  return;
+}
+
+template< class T >
+std::ostream&
+operator<<( std::ostream& out,
+            const CYK_Session<T>& other ) {
+  out << other.cyk_table();
+  return out;
+}
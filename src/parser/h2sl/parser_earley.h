@@ -0,0 +1,203 @@
+/**
+ * @file    parser_earley.h
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The definition of a class that describes an earley parser
+ */
+
+#ifndef H2SL_PARSER_EARLEY_H
+#define H2SL_PARSER_EARLEY_H
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <set>
+#include <cmath>
+#include <stdint.h>
+#include <boost/unordered_map.hpp>
+
+#include "h2sl/common.h"
+#include "h2sl/parser.h"
+
+namespace h2sl {
+  /**
+   * a rule lhs -> rhs of any length taken from the grammar as written, with 
+   *   indices into Grammar::symbols() and the log of its probability
+   */
+  class Earley_Rule {
+  public:
+    Earley_Rule( const int& lhs = -1, const std::vector< int >& rhs = std::vector< int >(), const double& logProb = 0.0 ) : lhs( lhs ), rhs( rhs ), log_prob( logProb ) {};
+    virtual ~Earley_Rule(){};
+
+    int lhs;
+    std::vector< int > rhs;
+    double log_prob;
+  };
+
+  /**
+   * a dotted rule that started at word origin; each link of the packed forest 
+   *   is a way of reaching it, the item before the last advance of the dot 
+   *   ( -1 for none ) and the node of the symbol that the dot advanced over
+   */
+  class Earley_Item {
+  public:
+    Earley_Item( const int& rule = -1, const unsigned int& dot = 0, const unsigned int& origin = 0 ) : rule( rule ), dot( dot ), origin( origin ), links() {};
+    virtual ~Earley_Item(){};
+
+    int rule;
+    unsigned int dot;
+    unsigned int origin;
+    std::vector< std::pair< int, int > > links;
+  };
+
+  /**
+   * a node of the packed forest for a symbol that covers words [ start, end ); 
+   *   items are the completed items that derive it, and a word has none
+   */
+  class Earley_Node {
+  public:
+    Earley_Node( const int& symbol = -1, const unsigned int& start = 0, const unsigned int& end = 0, const double& logProb = 0.0 ) : symbol( symbol ), start( start ), end( end ), log_prob( logProb ), items() {};
+    virtual ~Earley_Node(){};
+
+    int symbol;
+    unsigned int start;
+    unsigned int end;
+    double log_prob;
+    std::vector< int > items;
+  };
+
+  /**
+   * a derivation of an item or a node: the link or item it uses and the 
+   *   ranks of the derivations below it; derivations are ordered by 
+   *   decreasing log probability
+   */
+  class Earley_Derivation {
+  public:
+    Earley_Derivation( const double& logProb = 0.0, const int& alternative = -1, const unsigned int& firstRank = 0, const unsigned int& secondRank = 0 ) : log_prob( logProb ), alternative( alternative ), first_rank( firstRank ), second_rank( secondRank ) {};
+    virtual ~Earley_Derivation(){};
+
+    bool operator<( const Earley_Derivation& other )const{ return log_prob > other.log_prob; };
+
+    double log_prob;
+    int alternative;
+    unsigned int first_rank;
+    unsigned int second_rank;
+  };
+
+  /**
+   * the chart holds one set of items per position between words; the items 
+   *   and the nodes they complete form a shared packed forest that is read 
+   *   back into phrases the same way as Parser_CYK reads its chart
+   */
+  template< class T >
+  class Earley_Chart {
+  public:
+    Earley_Chart( const std::vector< Word >& words, const Grammar& grammar, const bool& probabilistic = false );
+    virtual ~Earley_Chart();
+    void fill( const Grammar& grammar );
+    void parse( std::vector< T* >& phrases, const unsigned int& maxParses = 0 );
+    void traverse( T* phrase, const unsigned int& item, const unsigned int& rank )const;
+
+    inline const std::vector< Word >& words( void )const{ return _words; };
+    inline const std::vector< std::string >& symbols( void )const{ return _symbols; };
+    inline const std::vector< Earley_Rule >& rules( void )const{ return _rules; };
+    inline const std::vector< Earley_Item >& items( void )const{ return _items; };
+    inline const std::vector< std::vector< int > >& sets( void )const{ return _sets; };
+    inline const std::vector< Earley_Node >& nodes( void )const{ return _nodes; };
+
+  protected:
+    void _add_item( const unsigned int& set, const unsigned int& rule, const unsigned int& dot, const unsigned int& origin, const int& prev, const int& node );
+    void _advance( const unsigned int& set, const unsigned int& item, const int& node );
+    void _complete( const unsigned int& set, const unsigned int& item );
+    int _node( const int& symbol, const unsigned int& start, const unsigned int& end, bool& created );
+    bool _expand_item( const unsigned int& item );
+    bool _expand_node( const unsigned int& node );
+    void _sort_derivations( std::vector< Earley_Derivation >& derivations )const;
+    void _traverse_node( T* phrase, const unsigned int& node, const unsigned int& rank )const;
+    std::string _phrase_key( const Phrase* phrase )const;
+
+    const std::vector< Word > _words;
+    const std::vector< std::string > _symbols;
+    const bool _probabilistic;
+    unsigned int _max_derivations;
+    std::vector< Earley_Rule > _rules;
+    std::vector< std::vector< unsigned int > > _lhs_rules;
+    std::vector< Earley_Item > _items;
+    std::vector< std::vector< int > > _sets;
+    std::vector< boost::unordered_map< uint64_t, int > > _item_indices;
+    std::vector< std::vector< std::vector< int > > > _waiting_items;
+    std::vector< Earley_Node > _nodes;
+    boost::unordered_map< uint64_t, int > _node_indices;
+    std::vector< std::vector< Earley_Derivation > > _item_derivations;
+    std::vector< std::vector< Earley_Derivation > > _node_derivations;
+    std::vector< int > _item_states;
+    std::vector< int > _node_states;
+    std::vector< int > _symbol_pos_tags;
+    std::vector< int > _symbol_phrase_types;
+    std::vector< bool > _symbol_placeholders;
+
+  };
+
+  template< class T >
+  std::ostream& operator<<( std::ostream& out, const Earley_Chart<T>& other );
+
+  /**
+   * an earley parser that reads the non-terminals and unit productions of the 
+   *   grammar as written, so rules of any length need no binarization, and 
+   *   returns the same phrases as Parser_CYK
+   */
+  template< class T >
+  class Parser_Earley: public Parser<T> {
+  public:
+    Parser_Earley( const unsigned int& maxParses = 0, const bool& probabilistic = false );
+    virtual ~Parser_Earley();
+    Parser_Earley( const Parser_Earley<T>& other );
+    Parser_Earley<T>& operator=( const Parser_Earley<T>& other );
+
+    virtual bool parse( const Grammar& grammar, const std::string& text, std::vector<T*>& phrases, const bool& debug = false )const;
+
+    inline unsigned int& max_parses( void ){ return _max_parses; };
+    inline const unsigned int& max_parses( void )const{ return _max_parses; };
+    inline bool& probabilistic( void ){ return _probabilistic; };
+    inline const bool& probabilistic( void )const{ return _probabilistic; };
+
+  protected:
+    unsigned int _max_parses;
+    bool _probabilistic;
+
+  private:
+
+  };
+
+  template< class T >
+  std::ostream& operator<<( std::ostream& out, const Parser_Earley<T>& other );
+  #include "h2sl/parser_earley.ipp"
+}
+
+#endif /* H2SL_PARSER_EARLEY_H */
@@ -0,0 +1,561 @@
+/**
+ * @file    parser_earley.ipp
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of a class that describes an earley parser
+ */
+
+template< class T >
+Earley_Chart<T>::
+Earley_Chart( const std::vector< Word >& words,
+              const Grammar& grammar,
+              const bool& probabilistic ) : _words( words ),
+                                            _symbols( grammar.symbols() ),
+                                            _probabilistic( probabilistic ),
+                                            _max_derivations( 0 ),
+                                            _rules(),
+                                            _lhs_rules( grammar.symbols().size() ),
+                                            _items(),
+                                            _sets( words.size() + 1 ),
+                                            _item_indices( words.size() + 1 ),
+                                            _waiting_items( words.size() + 1, std::vector< std::vector< int > >( grammar.symbols().size() ) ),
+                                            _nodes(),
+                                            _node_indices(),
+                                            _item_derivations(),
+                                            _node_derivations(),
+                                            _item_states(),
+                                            _node_states(),
+                                            _symbol_pos_tags( grammar.symbols().size(), -1 ),
+                                            _symbol_phrase_types( grammar.symbols().size(), -1 ),
+                                            _symbol_placeholders( grammar.symbols().size(), false ) {
+  for( unsigned int i = 0; i < _symbols.size(); i++ ){
+    for( unsigned int j = 0; j < NUM_POS_TAGS; j++ ){
+      if( pos_t_to_std_string( ( pos_t )( j ) ) == _symbols[ i ] ){
+        _symbol_pos_tags[ i ] = j;
+      }
+    }
+    for( unsigned int j = 0; j < NUM_PHRASE_TYPES; j++ ){
+      if( Phrase::phrase_type_t_to_std_string( ( phrase_type_t )( j ) ) == _symbols[ i ] ){
+        _symbol_phrase_types[ i ] = j;
+      }
+    }
+    for( unsigned int j = 0; j < NUM_PHRASE_PLACEHOLDERS; j++ ){
+      if( Grammar::grammar_placeholder_t_to_std_string( ( grammar_placeholder_t )( j ) ) == _symbols[ i ] ){
+        _symbol_placeholders[ i ] = true;
+      }
+    }
+  }
+
+  // rules with a symbol outside of the grammar's symbols can never apply
+  for( unsigned int i = 0; i < grammar.non_terminals().size(); i++ ){
+    const std::vector< std::string >& elements = grammar.non_terminals()[ i ].elements();
+    if( elements.size() > 1 ){
+      Earley_Rule rule( grammar.symbol_index( elements.front() ), std::vector< int >(), _probabilistic ? log( grammar.non_terminals()[ i ].prob() ) : 0.0 );
+      bool known = ( rule.lhs >= 0 );
+      for( unsigned int j = 1; j < elements.size(); j++ ){
+        rule.rhs.push_back( grammar.symbol_index( elements[ j ] ) );
+        known = known && ( rule.rhs.back() >= 0 );
+      }
+      if( known ){
+        _rules.push_back( rule );
+      }
+    }
+  }
+  // unit productions that close a cycle are not followed, as in Parser_CYK
+  for( unsigned int i = 0; i < grammar.unit_productions().size(); i++ ){
+    const Grammar_Unit_Production& unit_production = grammar.unit_productions()[ i ];
+    Earley_Rule rule( grammar.symbol_index( Phrase::phrase_type_t_to_std_string( unit_production.type() ) ), std::vector< int >( 1, grammar.symbol_index( unit_production.symbol() ) ), _probabilistic ? log( unit_production.prob() ) : 0.0 );
+    if( ( rule.lhs >= 0 ) && ( rule.rhs.front() >= 0 ) && !grammar.unit_closures()[ rule.lhs ][ rule.rhs.front() ] ){
+      _rules.push_back( rule );
+    }
+  }
+  for( unsigned int i = 0; i < _rules.size(); i++ ){
+    _lhs_rules[ _rules[ i ].lhs ].push_back( i );
+  }
+}
+
+template< class T >
+Earley_Chart<T>::
+~Earley_Chart() {
+
+}
+
+/**
+ * runs the predictor, completer and scanner over the sets of items from the 
+ *   first word to the last; no rule is empty, so every item that completes 
+ *   in a set started in an earlier set that is already finished
+ */
+template< class T >
+void
+Earley_Chart<T>::
+fill( const Grammar& grammar ){
+  if( _words.empty() ){
+    return;
+  }
+
+  for( unsigned int i = 0; i < _rules.size(); i++ ){
+    _add_item( 0, i, 0, 0, -1, -1 );
+  }
+
+  for( unsigned int i = 0; i <= _words.size(); i++ ){
+    for( unsigned int j = 0; j < _sets[ i ].size(); j++ ){
+      const Earley_Item& item = _items[ _sets[ i ][ j ] ];
+      const Earley_Rule& rule = _rules[ item.rule ];
+      if( item.dot < rule.rhs.size() ){
+        const std::vector< unsigned int >& predictions = _lhs_rules[ rule.rhs[ item.dot ] ];
+        for( unsigned int k = 0; k < predictions.size(); k++ ){
+          _add_item( i, predictions[ k ], 0, i, -1, -1 );
+        }
+      } else {
+        _complete( i, _sets[ i ][ j ] );
+      }
+    }
+
+    // an unknown word leaves a position that no item can pass, so nothing parses
+    if( i < _words.size() ){
+      boost::unordered_map< std::string, std::vector< std::pair< int, double > > >::const_iterator it = grammar.lexicon().find( _words[ i ].text() );
+      if( it == grammar.lexicon().end() ){
+        return;
+      }
+      for( unsigned int j = 0; j < it->second.size(); j++ ){
+        const std::vector< int >& waiting_items = _waiting_items[ i ][ it->second[ j ].first ];
+        if( waiting_items.empty() ){
+          continue;
+        }
+        bool created = false;
+        int node = _node( it->second[ j ].first, i, i + 1, created );
+        _nodes[ node ].log_prob = _probabilistic ? it->second[ j ].second : 0.0;
+        for( unsigned int k = 0; k < waiting_items.size(); k++ ){
+          _advance( i + 1, waiting_items[ k ], node );
+        }
+      }
+    }
+  }
+  return;
+}
+
+/**
+ * reads the complete parses out of the forest; a parse is a rule with two 
+ *   or more symbols that covers every word, as the sentence span of 
+ *   Parser_CYK takes no unit productions
+ */
+template< class T >
+void
+Earley_Chart<T>::
+parse( std::vector< T* >& phrases,
+        const unsigned int& maxParses ){
+  for( unsigned int i = 0; i < phrases.size(); i++ ){
+    if( phrases[ i ] != NULL ){
+      delete phrases[ i ];
+      phrases[ i ] = NULL;
+    }
+  }
+  phrases.clear();
+
+  if( _words.empty() ){
+    return;
+  }
+
+  _max_derivations = maxParses;
+  _item_derivations.assign( _items.size(), std::vector< Earley_Derivation >() );
+  _node_derivations.assign( _nodes.size(), std::vector< Earley_Derivation >() );
+  _item_states.assign( _items.size(), 0 );
+  _node_states.assign( _nodes.size(), 0 );
+
+  std::vector< Earley_Derivation > roots;
+  for( unsigned int i = 0; i < _sets[ _words.size() ].size(); i++ ){
+    int item = _sets[ _words.size() ][ i ];
+    const Earley_Rule& rule = _rules[ _items[ item ].rule ];
+    if( ( _items[ item ].origin == 0 ) && ( _items[ item ].dot == rule.rhs.size() ) && ( rule.rhs.size() > 1 ) && _expand_item( item ) ){
+      for( unsigned int j = 0; j < _item_derivations[ item ].size(); j++ ){
+        roots.push_back( Earley_Derivation( _item_derivations[ item ][ j ].log_prob + rule.log_prob, item, j ) );
+      }
+    }
+  }
+  _sort_derivations( roots );
+
+  std::set< std::string > keys;
+  for( unsigned int i = 0; ( i < roots.size() ) && ( ( maxParses == 0 ) || ( phrases.size() < maxParses ) ); i++ ){
+    phrases.push_back( new T() );
+    traverse( phrases.back(), roots[ i ].alternative, roots[ i ].first_rank );
+    if( !keys.insert( _phrase_key( phrases.back() ) ).second ){
+      delete phrases.back();
+      phrases.pop_back();
+    }
+  }
+  return;
+}
+
+/**
+ * fills a phrase from a derivation of a completed item: words for the 
+ *   part-of-speech symbols, child phrases for the phrase symbols and the 
+ *   contents of placeholder symbols in place
+ */
+template< class T >
+void
+Earley_Chart<T>::
+traverse( T* phrase,
+          const unsigned int& item,
+          const unsigned int& rank )const{
+  int symbol = _rules[ _items[ item ].rule ].lhs;
+  if( _symbol_phrase_types[ symbol ] >= 0 ){
+    phrase->type() = ( phrase_type_t )( _symbol_phrase_types[ symbol ] );
+  }
+
+  // the links run from the last symbol of the rule back to the first
+  std::vector< std::pair< int, unsigned int > > children;
+  int child_item = item;
+  unsigned int child_rank = rank;
+  while( child_item >= 0 ){
+    const Earley_Derivation& derivation = _item_derivations[ child_item ][ child_rank ];
+    const std::pair< int, int >& link = _items[ child_item ].links[ derivation.alternative ];
+    children.push_back( std::pair< int, unsigned int >( link.second, derivation.second_rank ) );
+    child_item = link.first;
+    child_rank = derivation.first_rank;
+  }
+  std::reverse( children.begin(), children.end() );
+
+  for( unsigned int i = 0; i < children.size(); i++ ){
+    const Earley_Node& node = _nodes[ children[ i ].first ];
+    if( _symbol_pos_tags[ node.symbol ] >= 0 ){
+      phrase->words().push_back( _words[ node.start ] );
+      phrase->words().back().pos() = ( pos_t )( _symbol_pos_tags[ node.symbol ] );
+    }
+    if( _symbol_phrase_types[ node.symbol ] >= 0 ){
+      phrase->children().push_back( new T() );
+      _traverse_node( dynamic_cast< T* >( phrase->children().back() ), children[ i ].first, children[ i ].second );
+    }
+    if( _symbol_placeholders[ node.symbol ] ){
+      _traverse_node( phrase, children[ i ].first, children[ i ].second );
+    }
+  }
+  return;
+}
+
+template< class T >
+void
+Earley_Chart<T>::
+_add_item( const unsigned int& set,
+            const unsigned int& rule,
+            const unsigned int& dot,
+            const unsigned int& origin,
+            const int& prev,
+            const int& node ){
+  uint64_t key = ( ( ( uint64_t )( rule ) << 32 ) | ( ( uint64_t )( dot ) << 16 ) | ( uint64_t )( origin ) );
+  int item = -1;
+  boost::unordered_map< uint64_t, int >::const_iterator it = _item_indices[ set ].find( key );
+  if( it == _item_indices[ set ].end() ){
+    item = _items.size();
+    _items.push_back( Earley_Item( rule, dot, origin ) );
+    _item_indices[ set ].insert( std::pair< uint64_t, int >( key, item ) );
+    _sets[ set ].push_back( item );
+    if( dot < _rules[ rule ].rhs.size() ){
+      _waiting_items[ set ][ _rules[ rule ].rhs[ dot ] ].push_back( item );
+    }
+  } else {
+    item = it->second;
+  }
+  if( node >= 0 ){
+    _items[ item ].links.push_back( std::pair< int, int >( prev, node ) );
+  }
+  return;
+}
+
+/**
+ * adds the item that moves the dot of an item over the symbol of a node to 
+ *   a set, linked to both
+ */
+template< class T >
+void
+Earley_Chart<T>::
+_advance( const unsigned int& set,
+          const unsigned int& item,
+          const int& node ){
+  unsigned int rule = _items[ item ].rule;
+  unsigned int dot = _items[ item ].dot;
+  unsigned int origin = _items[ item ].origin;
+  _add_item( set, rule, dot + 1, origin, ( dot > 0 ) ? ( int )( item ) : -1, node );
+  return;
+}
+
+/**
+ * adds a completed item to the node of its symbol and, the first time that 
+ *   node appears, advances the items of its origin that wait for the symbol
+ */
+template< class T >
+void
+Earley_Chart<T>::
+_complete( const unsigned int& set,
+            const unsigned int& item ){
+  int symbol = _rules[ _items[ item ].rule ].lhs;
+  unsigned int origin = _items[ item ].origin;
+  bool created = false;
+  int node = _node( symbol, origin, set, created );
+  _nodes[ node ].items.push_back( item );
+  if( created ){
+    const std::vector< int >& waiting_items = _waiting_items[ origin ][ symbol ];
+    for( unsigned int i = 0; i < waiting_items.size(); i++ ){
+      _advance( set, waiting_items[ i ], node );
+    }
+  }
+  return;
+}
+
+template< class T >
+int
+Earley_Chart<T>::
+_node( const int& symbol,
+        const unsigned int& start,
+        const unsigned int& end,
+        bool& created ){
+  uint64_t key = ( ( ( uint64_t )( symbol ) << 32 ) | ( ( uint64_t )( start ) << 16 ) | ( uint64_t )( end ) );
+  boost::unordered_map< uint64_t, int >::const_iterator it = _node_indices.find( key );
+  if( it != _node_indices.end() ){
+    created = false;
+    return it->second;
+  }
+  created = true;
+  _nodes.push_back( Earley_Node( symbol, start, end ) );
+  _node_indices.insert( std::pair< uint64_t, int >( key, _nodes.size() - 1 ) );
+  return _nodes.size() - 1;
+}
+
+/**
+ * enumerates the derivations of an item from those of its links; returns 
+ *   false for an item that is already being expanded further up, which 
+ *   leaves out derivations that go around a cycle of unit productions
+ */
+template< class T >
+bool
+Earley_Chart<T>::
+_expand_item( const unsigned int& item ){
+  if( _item_states[ item ] == 1 ){
+    return false;
+  } else if( _item_states[ item ] == 2 ){
+    return true;
+  }
+  _item_states[ item ] = 1;
+
+  std::vector< Earley_Derivation >& derivations = _item_derivations[ item ];
+  for( unsigned int i = 0; i < _items[ item ].links.size(); i++ ){
+    const std::pair< int, int >& link = _items[ item ].links[ i ];
+    if( !_expand_node( link.second ) ){
+      continue;
+    }
+    if( link.first < 0 ){
+      for( unsigned int j = 0; j < _node_derivations[ link.second ].size(); j++ ){
+        derivations.push_back( Earley_Derivation( _node_derivations[ link.second ][ j ].log_prob, i, 0, j ) );
+      }
+    } else if( _expand_item( link.first ) ){
+      for( unsigned int j = 0; j < _item_derivations[ link.first ].size(); j++ ){
+        for( unsigned int k = 0; k < _node_derivations[ link.second ].size(); k++ ){
+          derivations.push_back( Earley_Derivation( _item_derivations[ link.first ][ j ].log_prob + _node_derivations[ link.second ][ k ].log_prob, i, j, k ) );
+        }
+      }
+    }
+  }
+  _sort_derivations( derivations );
+
+  _item_states[ item ] = 2;
+  return true;
+}
+
+template< class T >
+bool
+Earley_Chart<T>::
+_expand_node( const unsigned int& node ){
+  if( _node_states[ node ] == 1 ){
+    return false;
+  } else if( _node_states[ node ] == 2 ){
+    return true;
+  }
+  _node_states[ node ] = 1;
+
+  std::vector< Earley_Derivation >& derivations = _node_derivations[ node ];
+  if( _nodes[ node ].items.empty() ){
+    derivations.push_back( Earley_Derivation( _nodes[ node ].log_prob ) );
+  }
+  for( unsigned int i = 0; i < _nodes[ node ].items.size(); i++ ){
+    int item = _nodes[ node ].items[ i ];
+    if( _expand_item( item ) ){
+      for( unsigned int j = 0; j < _item_derivations[ item ].size(); j++ ){
+        derivations.push_back( Earley_Derivation( _item_derivations[ item ][ j ].log_prob + _rules[ _items[ item ].rule ].log_prob, i, j ) );
+      }
+    }
+  }
+  _sort_derivations( derivations );
+
+  _node_states[ node ] = 2;
+  return true;
+}
+
+/**
+ * orders derivations by decreasing log probability when probabilistic and 
+ *   keeps at most the maximum number of parses of them
+ */
+template< class T >
+void
+Earley_Chart<T>::
+_sort_derivations( std::vector< Earley_Derivation >& derivations )const{
+  if( _probabilistic ){
+    std::stable_sort( derivations.begin(), derivations.end() );
+  }
+  if( ( _max_derivations > 0 ) && ( derivations.size() > _max_derivations ) ){
+    derivations.resize( _max_derivations );
+  }
+  return;
+}
+
+template< class T >
+void
+Earley_Chart<T>::
+_traverse_node( T* phrase,
+                const unsigned int& node,
+                const unsigned int& rank )const{
+  const Earley_Derivation& derivation = _node_derivations[ node ][ rank ];
+  if( derivation.alternative >= 0 ){
+    traverse( phrase, _nodes[ node ].items[ derivation.alternative ], derivation.first_rank );
+  }
+  return;
+}
+
+/**
+ * a string that is equal for two phrases when they are identical
+ */
+template< class T >
+std::string
+Earley_Chart<T>::
+_phrase_key( const Phrase* phrase )const{
+  std::stringstream key;
+  key << phrase->type() << "|" << phrase->text().size() << " " << phrase->text() << "|" << phrase->words().size() << "|";
+  for( unsigned int i = 0; i < phrase->words().size(); i++ ){
+    key << phrase->words()[ i ].pos() << " " << phrase->words()[ i ].text().size() << " " << phrase->words()[ i ].text() << "|";
+  }
+  key << phrase->children().size();
+  for( unsigned int i = 0; i < phrase->children().size(); i++ ){
+    key << "(" << _phrase_key( phrase->children()[ i ] ) << ")";
+  }
+  return key.str();
+}
+
+template< class T >
+std::ostream&
+operator<<( std::ostream& out,
+            const Earley_Chart<T>& other ) {
+  for( unsigned int i = 0; i < other.sets().size(); i++ ){
+    out << "set[" << i << "]:";
+    if( i > 0 ){
+      out << " \"" << other.words()[ i - 1 ].text() << "\"";
+    }
+    out << std::endl;
+    for( unsigned int j = 0; j < other.sets()[ i ].size(); j++ ){
+      const Earley_Item& item = other.items()[ other.sets()[ i ][ j ] ];
+      const Earley_Rule& rule = other.rules()[ item.rule ];
+      out << "  " << other.symbols()[ rule.lhs ] << " ->";
+      for( unsigned int k = 0; k <= rule.rhs.size(); k++ ){
+        if( k == item.dot ){
+          out << " .";
+        }
+        if( k < rule.rhs.size() ){
+          out << " " << other.symbols()[ rule.rhs[ k ] ];
+        }
+      }
+      out << " [" << item.origin << "] links:" << item.links.size() << std::endl;
+    }
+  }
+  return out;
+}
+
+template< class T >
+Parser_Earley<T>::
+Parser_Earley( const unsigned int& maxParses,
+                const bool& probabilistic ) : Parser<T>(),
+                                              _max_parses( maxParses ),
+                                              _probabilistic( probabilistic ) {
+
+}
+
+template< class T >
+Parser_Earley<T>::
+~Parser_Earley() {
+
+}
+
+template< class T >
+Parser_Earley<T>::
+Parser_Earley( const Parser_Earley<T>& other ) : Parser<T>( other ),
+                                                  _max_parses( other._max_parses ),
+                                                  _probabilistic( other._probabilistic ) {
+
+}
+
+template< class T >
+Parser_Earley<T>&
+Parser_Earley<T>::
+operator=( const Parser_Earley<T>& other ) {
+  _max_parses = other._max_parses;
+  _probabilistic = other._probabilistic;
+  return (*this);
+}
+
+template< class T >
+bool
+Parser_Earley<T>::
+parse( const Grammar& grammar,
+        const std::string& text,
+        std::vector<T*>& phrases,
+        const bool& debug )const{
+  std::vector< Word > words;
+  this->_text_to_words( text, words );
+
+  Earley_Chart<T> * earley_chart = new Earley_Chart<T>( words, grammar, _probabilistic );
+
+  earley_chart->fill( grammar );
+  earley_chart->parse( phrases, _max_parses );
+
+  if( debug ){
+    if( earley_chart != NULL ){
+      std::cout << *earley_chart << std::endl;
+    }
+  }
+
+  if( earley_chart != NULL ){
+    delete earley_chart;
+    earley_chart = NULL;
+  }
+
+  return !phrases.empty();
+}
+
+template< class T >
+std::ostream&
+operator<<( std::ostream& out,
+            const Parser_Earley<T>& other ) {
+  return out;
+}
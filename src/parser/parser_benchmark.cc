@@ -0,0 +1,216 @@
+/**
+ * @file    parser_benchmark.cc
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * A program that compares the Parser_CYK and Parser_Earley classes on the 
+ * instructions of a set of examples
+ */
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <sys/time.h>
+#include <boost/algorithm/string.hpp>
+#include "h2sl/common.h"
+#include "h2sl/phrase.h"
+#include "h2sl/parser_cyk.h"
+#include "h2sl/parser_earley.h"
+#include "h2sl/parser_cache.h"
+#include "parser_benchmark_cmdline.h"
+
+using namespace std;
+using namespace h2sl;
+
+string
+extract_instruction( const std::string& filename ){
+  string instruction = "";
+  xmlDoc * doc = NULL;
+  xmlNodePtr root = NULL;
+  doc = xmlReadFile( filename.c_str(), NULL, 0 );
+  if( doc != NULL ){
+    root = xmlDocGetRootElement( doc );
+    if( root->type == XML_ELEMENT_NODE ){
+      xmlNodePtr l1 = NULL;
+      for( l1 = root->children; l1; l1 = l1->next ){
+        if( l1->type == XML_ELEMENT_NODE ){
+          if( xmlStrcmp( l1->name, ( const xmlChar* )( "instruction" ) ) == 0 ){
+            xmlChar * tmp = xmlGetProp( l1, ( const xmlChar* )( "text" ) );
+            if( tmp != NULL ){
+              instruction = ( char* )( tmp );
+              xmlFree( tmp );
+            }
+          }
+        }
+      }
+    }
+    xmlFreeDoc( doc );
+  }
+  return instruction;
+}
+
+/**
+ * parses every instruction the given number of times, keeps the parses of 
+ *   the last time and returns the run time in seconds
+ */
+double
+benchmark_parser( const Parser< Phrase >* parser,
+                  const Grammar& grammar,
+                  const vector< string >& instructions,
+                  const unsigned int& iterations,
+                  vector< vector< string > >& parses ){
+  struct timeval start_time;
+  gettimeofday( &start_time, NULL );
+
+  parses.clear();
+  parses.resize( instructions.size() );
+  vector< Phrase* > phrases;
+  for( unsigned int i = 0; i < iterations; i++ ){
+    for( unsigned int j = 0; j < instructions.size(); j++ ){
+      parser->parse( grammar, instructions[ j ], phrases );
+      if( i == ( iterations - 1 ) ){
+        for( unsigned int k = 0; k < phrases.size(); k++ ){
+          stringstream phrase_string;
+          phrase_string << *phrases[ k ];
+          parses[ j ].push_back( phrase_string.str() );
+        }
+        sort( parses[ j ].begin(), parses[ j ].end() );
+      }
+      for( unsigned int k = 0; k < phrases.size(); k++ ){
+        if( phrases[ k ] != NULL ){
+          delete phrases[ k ];
+          phrases[ k ] = NULL;
+        }
+      }
+      phrases.clear();
+    }
+  }
+
+  struct timeval end_time;
+  gettimeofday( &end_time, NULL );
+  return diff_time( start_time, end_time );
+}
+
+int
+main( int argc,
+      char* argv[] ) {
+  int status = 0;
+  cout << "start of parser benchmark program" << endl;
+
+  gengetopt_args_info args;
+  if( cmdline_parser( argc, argv, &args ) != 0 ){
+    exit(1);
+  }
+
+  Grammar * grammar = new Grammar();
+  grammar->from_xml( args.grammar_arg );
+
+  // extra unit productions, such as a pair that forms a cycle
+  if( args.unit_productions_given ){
+    vector< string > unit_productions;
+    boost::split( unit_productions, args.unit_productions_arg, boost::is_any_of( "," ) );
+    for( unsigned int i = 0; i < unit_productions.size(); i++ ){
+      vector< string > unit_production;
+      boost::split( unit_production, unit_productions[ i ], boost::is_any_of( ":" ) );
+      if( unit_production.size() == 2 ){
+        grammar->unit_productions().push_back( Grammar_Unit_Production( Phrase::phrase_type_t_from_std_string( unit_production[ 0 ] ), unit_production[ 1 ] ) );
+      } else {
+        cout << "skipping unit production \"" << unit_productions[ i ] << "\"" << endl;
+      }
+    }
+    grammar->compile();
+  }
+
+  vector< string > instructions;
+  for( unsigned int i = 0; i < args.inputs_num; i++ ){
+    instructions.push_back( extract_instruction( args.inputs[ i ] ) );
+  }
+
+  unsigned int iterations = ( args.iterations_arg > 0 ) ? args.iterations_arg : 1;
+
+  Parser_CYK< Phrase > * parser_cyk = new Parser_CYK< Phrase >( args.max_parses_arg, ( args.probabilistic_arg != 0 ) );
+  vector< vector< string > > cyk_parses;
+  double cyk_time = benchmark_parser( parser_cyk, *grammar, instructions, iterations, cyk_parses );
+
+  Parser_Earley< Phrase > * parser_earley = new Parser_Earley< Phrase >( args.max_parses_arg, ( args.probabilistic_arg != 0 ) );
+  vector< vector< string > > earley_parses;
+  double earley_time = benchmark_parser( parser_earley, *grammar, instructions, iterations, earley_parses );
+
+  Parser_Cache< Phrase > * parser_cache = NULL;
+  vector< vector< string > > cache_parses;
+  double cache_time = 0.0;
+  if( args.cache_size_arg > 0 ){
+    parser_cache = new Parser_Cache< Phrase >( parser_cyk, args.cache_size_arg );
+    cache_time = benchmark_parser( parser_cache, *grammar, instructions, iterations, cache_parses );
+  }
+
+  unsigned int num_matches = 0;
+  for( unsigned int i = 0; i < instructions.size(); i++ ){
+    if( ( cyk_parses[ i ] == earley_parses[ i ] ) && ( ( parser_cache == NULL ) || ( cyk_parses[ i ] == cache_parses[ i ] ) ) ){
+      num_matches++;
+    } else {
+      cout << "parses differ for \"" << instructions[ i ] << "\" (" << cyk_parses[ i ].size() << " cyk, " << earley_parses[ i ].size() << " earley";
+      if( parser_cache != NULL ){
+        cout << ", " << cache_parses[ i ].size() << " cached cyk";
+      }
+      cout << ")" << endl;
+    }
+  }
+
+  unsigned int num_parses = instructions.size() * iterations;
+  cout << "parsed " << instructions.size() << " instructions " << iterations << " times" << endl;
+  cout << "  cyk:    " << cyk_time << " sec (" << ( ( num_parses > 0 ) ? ( cyk_time / ( double )( num_parses ) * 1000.0 ) : 0.0 ) << " msec per instruction)" << endl;
+  cout << "  earley: " << earley_time << " sec (" << ( ( num_parses > 0 ) ? ( earley_time / ( double )( num_parses ) * 1000.0 ) : 0.0 ) << " msec per instruction)" << endl;
+  if( parser_cache != NULL ){
+    cout << "  cached cyk: " << cache_time << " sec (" << ( ( num_parses > 0 ) ? ( cache_time / ( double )( num_parses ) * 1000.0 ) : 0.0 ) << " msec per instruction, " << *parser_cache << ")" << endl;
+  }
+  cout << "same parses for " << num_matches << " of " << instructions.size() << " instructions" << endl;
+
+  if( parser_cache != NULL ){
+    delete parser_cache;
+    parser_cache = NULL;
+  }
+
+  if( parser_earley != NULL ){
+    delete parser_earley;
+    parser_earley = NULL;
+  }
+
+  if( parser_cyk != NULL ){
+    delete parser_cyk;
+    parser_cyk = NULL;
+  }
+
+  if( grammar != NULL ){
+    delete grammar;
+    grammar = NULL;
+  }
+
+  cout << "end of parser benchmark program" << endl;
+  return status;
+}
@@ -53,12 +53,29 @@ main( int argc,
     exit(1);
   }
 
-  Parser_CYK< Phrase >* parser_cyk = new Parser_CYK< Phrase >();
+  Parser_CYK< Phrase >* parser_cyk = new Parser_CYK< Phrase >( args.max_parses_arg, ( args.probabilistic_arg != 0 ), args.beam_width_arg, args.threads_arg, args.parallel_threshold_arg );
   Grammar * grammar = new Grammar();
   grammar->from_xml( args.grammar_arg );
 
   vector< Phrase* > phrases;
-  if( parser_cyk->parse( *grammar, args.command_arg, phrases, ( bool )( args.debug_arg ) ) ){
+  bool success = false;
+  if( args.incremental_arg ){
+    CYK_Session< Phrase > cyk_session( *grammar, *parser_cyk );
+    vector< string > words;
+    boost::split( words, args.command_arg, boost::is_any_of( " " ) );
+    for( unsigned int i = 0; i < words.size(); i++ ){
+      cyk_session.append( words[ i ] );
+      success = cyk_session.parses( phrases );
+      cout << "appended \"" << words[ i ] << "\" (" << phrases.size() << " complete parses)" << endl;
+    }
+    if( args.debug_arg ){
+      cout << cyk_session << endl;
+    }
+  } else {
+    success = parser_cyk->parse( *grammar, args.command_arg, phrases, ( bool )( args.debug_arg ) );
+  }
+
+  if( success ){
     cout << "successfully parsed \"" << args.command_arg << "\"" << endl;
   } else {
     cout << "failed to parse \"" << args.command_arg << "\"" << endl;
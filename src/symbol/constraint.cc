@@ -31,6 +31,8 @@
  * The implementation of a class used to represent a constraint
  */
 
+#include <boost/functional/hash.hpp>
+
 #include "h2sl/constraint.h"
 
 using namespace std;
@@ -100,6 +102,19 @@ dup( void )const{
   return new Constraint( *this );
 }
 
+size_t
+Constraint::
+hash( void )const{
+  size_t seed = 0;
+  for( map< string, string >::const_iterator it = _properties.begin(); it != _properties.end(); it++ ){
+    boost::hash_combine( seed, it->first );
+    boost::hash_combine( seed, it->second );
+  }
+  boost::hash_combine( seed, _parent.hash() );
+  boost::hash_combine( seed, _child.hash() );
+  return seed;
+}
+
 void
 Constraint::
 to_xml( const string& filename )const{
@@ -52,6 +52,7 @@ namespace h2sl {
     bool operator==( const Object& other )const;
     bool operator!=( const Object& other )const;
     virtual Object* dup( void )const;
+    virtual std::size_t hash( void )const;
 
     virtual void to_xml( const std::string& filename )const;
     virtual void to_xml( xmlDocPtr doc, xmlNodePtr root )const;
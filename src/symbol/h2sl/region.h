@@ -50,6 +50,7 @@ namespace h2sl {
     bool operator==( const Region& other )const;
     bool operator!=( const Region& other )const;
     virtual Grounding* dup( void )const;
+    virtual std::size_t hash( void )const;
 
     virtual void to_xml( const std::string& filename )const;
     virtual void to_xml( xmlDocPtr doc, xmlNodePtr root )const;
@@ -47,6 +47,7 @@ namespace h2sl {
     World( const World& other );
     World& operator=( const World& other );
     virtual World* dup( void )const;
+    virtual std::size_t hash( void )const;
 
     virtual void to_xml( const std::string& filename )const;
     virtual void to_xml( xmlDocPtr doc, xmlNodePtr root )const;
@@ -0,0 +1,76 @@
+/**
+ * @file    world_diff.h
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The interface for a class used to represent the change between two worlds
+ */
+
+#ifndef H2SL_WORLD_DIFF_H
+#define H2SL_WORLD_DIFF_H
+
+#include <iostream>
+#include <vector>
+
+#include "h2sl/world.h"
+
+namespace h2sl {
+  /**
+   * objects are matched between worlds by name and compared by content; changed
+   *   objects hold their new state
+   */
+  class World_Diff {
+  public:
+    World_Diff( const std::vector< Object >& added = std::vector< Object >(), const std::vector< std::string >& removed = std::vector< std::string >(), const std::vector< Object >& changed = std::vector< Object >() );
+    World_Diff( const World* before, const World* after );
+    virtual ~World_Diff();
+    World_Diff( const World_Diff& other );
+    World_Diff& operator=( const World_Diff& other );
+
+    bool empty( void )const;
+    bool changes_objects( void )const;
+
+    inline std::vector< Object >& added( void ){ return _added; };
+    inline const std::vector< Object >& added( void )const{ return _added; };
+    inline std::vector< std::string >& removed( void ){ return _removed; };
+    inline const std::vector< std::string >& removed( void )const{ return _removed; };
+    inline std::vector< Object >& changed( void ){ return _changed; };
+    inline const std::vector< Object >& changed( void )const{ return _changed; };
+
+  protected:
+    std::vector< Object > _added;
+    std::vector< std::string > _removed;
+    std::vector< Object > _changed;
+
+  private:
+
+  };
+  std::ostream& operator<<( std::ostream& out, const World_Diff& other );
+}
+
+#endif /* H2SL_WORLD_DIFF_H */
@@ -30,6 +30,8 @@
  * The implementation of a class used to describe an object
  */
 
+#include <boost/functional/hash.hpp>
+
 #include "h2sl/common.h"
 #include "h2sl/object.h"
 
@@ -105,6 +107,22 @@ Object::
 dup( void )const{
   return new Object( *this );
 }
+
+size_t
+Object::
+hash( void )const{
+  size_t seed = 0;
+  for( map< string, string >::const_iterator it = _properties.begin(); it != _properties.end(); it++ ){
+    boost::hash_combine( seed, it->first );
+    boost::hash_combine( seed, it->second );
+  }
+  boost::hash_combine( seed, _transform.position().data() );
+  boost::hash_combine( seed, _transform.orientation().qv().data() );
+  boost::hash_combine( seed, _transform.orientation().qs() );
+  boost::hash_combine( seed, _linear_velocity.data() );
+  boost::hash_combine( seed, _angular_velocity.data() );
+  return seed;
+}
  
 void
 Object::
@@ -31,6 +31,8 @@
  * The implementation of a class used to describe a region of space
  */
 
+#include <boost/functional/hash.hpp>
+
 #include "h2sl/region.h"
 
 using namespace std;
@@ -93,6 +95,18 @@ dup( void )const{
   return new Region( *this );
 }
 
+size_t
+Region::
+hash( void )const{
+  size_t seed = 0;
+  for( map< string, string >::const_iterator it = _properties.begin(); it != _properties.end(); it++ ){
+    boost::hash_combine( seed, it->first );
+    boost::hash_combine( seed, it->second );
+  }
+  boost::hash_combine( seed, _object.hash() );
+  return seed;
+}
+
 void
 Region::
 to_xml( const string& filename )const{
@@ -32,6 +32,8 @@
  */
 
 #include <sstream>
+#include <boost/functional/hash.hpp>
+
 #include "h2sl/world.h"
 
 using namespace std;
@@ -69,6 +71,21 @@ dup( void )const{
   return new World( *this );
 }
 
+/**
+ * hashes the content of the objects in order; the time is not included
+ */
+size_t
+World::
+hash( void )const{
+  size_t seed = _objects.size();
+  for( unsigned int i = 0; i < _objects.size(); i++ ){
+    if( _objects[ i ] != NULL ){
+      boost::hash_combine( seed, _objects[ i ]->hash() );
+    }
+  }
+  return seed;
+}
+
 void
 World::
 to_xml( const string& filename )const{
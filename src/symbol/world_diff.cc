@@ -0,0 +1,145 @@
+/**
+ * @file    world_diff.cc
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of a class used to represent the change between two worlds
+ */
+
+#include "h2sl/world_diff.h"
+
+using namespace std;
+using namespace h2sl;
+
+World_Diff::
+World_Diff( const vector< Object >& added,
+            const vector< string >& removed,
+            const vector< Object >& changed ) : _added( added ),
+                                                _removed( removed ),
+                                                _changed( changed ) {
+
+}
+
+World_Diff::
+World_Diff( const World* before,
+            const World* after ) : _added(),
+                                    _removed(),
+                                    _changed() {
+  for( unsigned int i = 0; i < after->objects().size(); i++ ){
+    const Object * before_object = NULL;
+    for( unsigned int j = 0; j < before->objects().size(); j++ ){
+      if( before->objects()[ j ]->name() == after->objects()[ i ]->name() ){
+        before_object = before->objects()[ j ];
+        break;
+      }
+    }
+    if( before_object == NULL ){
+      _added.push_back( *after->objects()[ i ] );
+    } else if( before_object->hash() != after->objects()[ i ]->hash() ){
+      _changed.push_back( *after->objects()[ i ] );
+    }
+  }
+  for( unsigned int i = 0; i < before->objects().size(); i++ ){
+    bool found = false;
+    for( unsigned int j = 0; j < after->objects().size(); j++ ){
+      if( after->objects()[ j ]->name() == before->objects()[ i ]->name() ){
+        found = true;
+        break;
+      }
+    }
+    if( !found ){
+      _removed.push_back( before->objects()[ i ]->name() );
+    }
+  }
+}
+
+World_Diff::
+~World_Diff() {
+
+}
+
+World_Diff::
+World_Diff( const World_Diff& other ) : _added( other._added ),
+                                        _removed( other._removed ),
+                                        _changed( other._changed ) {
+
+}
+
+World_Diff&
+World_Diff::
+operator=( const World_Diff& other ) {
+  _added = other._added;
+  _removed = other._removed;
+  _changed = other._changed;
+  return (*this);
+}
+
+bool
+World_Diff::
+empty( void )const{
+  return _added.empty() && _removed.empty() && _changed.empty();
+}
+
+/**
+ * true if objects were added or removed, which changes the size of the symbol space
+ */
+bool
+World_Diff::
+changes_objects( void )const{
+  return !_added.empty() || !_removed.empty();
+}
+
+namespace h2sl {
+  ostream&
+  operator<<( ostream& out,
+              const World_Diff& other ) {
+    out << "added[" << other.added().size() << "]:{";
+    for( unsigned int i = 0; i < other.added().size(); i++ ){
+      out << other.added()[ i ].name();
+      if( i != ( other.added().size() - 1 ) ){
+        out << ",";
+      }
+    }
+    out << "} removed[" << other.removed().size() << "]:{";
+    for( unsigned int i = 0; i < other.removed().size(); i++ ){
+      out << other.removed()[ i ];
+      if( i != ( other.removed().size() - 1 ) ){
+        out << ",";
+      }
+    }
+    out << "} changed[" << other.changed().size() << "]:{";
+    for( unsigned int i = 0; i < other.changed().size(); i++ ){
+      out << other.changed()[ i ].name();
+      if( i != ( other.changed().size() - 1 ) ){
+        out << ",";
+      }
+    }
+    out << "}";
+    return out;
+  }
+}
@@ -34,11 +34,35 @@
 #include <iostream>
 
 #include "h2sl/grammar.h"
+#include "h2sl/parser_cyk.h"
 #include "grammar_generator_cmdline.h"
 
 using namespace std;
 using namespace h2sl;
 
+std::string 
+extract_instruction( const std::string& filename ){
+  xmlDoc * doc = NULL;
+  xmlNodePtr root = NULL;
+  doc = xmlReadFile( filename.c_str(), NULL, 0 );
+  if( doc != NULL ){
+    root = xmlDocGetRootElement( doc );
+    if( root->type == XML_ELEMENT_NODE ){
+      for( xmlNodePtr l1 = root->children; l1; l1 = l1->next ){
+        if( matches_name( l1, "instruction" ) ){
+          pair< bool, string > text_prop = has_prop< std::string >( l1, "text" );
+          if( text_prop.first ){
+            xmlFreeDoc( doc );
+            return text_prop.second;
+          } 
+        }
+      }
+    }
+    xmlFreeDoc( doc );
+  }
+  return "";
+}
+
 void
 scrape_phrases( const Phrase* phrase,
                 vector< Grammar_Terminal >& terminals,
@@ -103,19 +127,37 @@ main( int argc,
   Grammar * grammar = new Grammar();
 
   if( grammar != NULL ){
-    for( unsigned int i = 0; i < args.inputs_num; i++ ){
-      Phrase * phrase = new Phrase();
-      if( phrase != NULL ){
-        phrase->from_xml( args.inputs[ i ] ); 
+    if( args.grammar_given ){
+      grammar->from_xml( args.grammar_arg );
+      vector< pair< string, const Phrase* > > examples;
+      for( unsigned int i = 0; i < args.inputs_num; i++ ){
+        Phrase * phrase = new Phrase();
+        phrase->from_xml( args.inputs[ i ] );
+        examples.push_back( pair< string, const Phrase* >( extract_instruction( args.inputs[ i ] ), phrase ) );
+      }
 
-        scrape_phrases( phrase, grammar->terminals(), grammar->non_terminals() ); 
+      Parser_CYK< Phrase > parser;
+      unsigned int num_examples = parser.estimate( *grammar, examples );
+      cout << "estimated rule probabilities from " << num_examples << " of " << examples.size() << " examples" << endl;
 
-        delete phrase;
-        phrase = NULL;
-      } else {
-        return 1;
+      for( unsigned int i = 0; i < examples.size(); i++ ){
+        delete examples[ i ].second;
       }
-    } 
+    } else {
+      for( unsigned int i = 0; i < args.inputs_num; i++ ){
+        Phrase * phrase = new Phrase();
+        if( phrase != NULL ){
+          phrase->from_xml( args.inputs[ i ] ); 
+
+          scrape_phrases( phrase, grammar->terminals(), grammar->non_terminals() ); 
+
+          delete phrase;
+          phrase = NULL;
+        } else {
+          return 1;
+        }
+      } 
+    }
 
     cout << "grammar terminals[" << grammar->terminals().size() << "{" << endl;
     for( unsigned int i = 0; i < grammar->terminals().size(); i++ ){
@@ -534,11 +534,11 @@ _run_inference( const string& sentence ){
       if( phrases.front() != NULL ){
         struct timeval start_time;
         gettimeofday( &start_time, NULL );
-        if( _dcg->leaf_search( phrases.front(), _world, _context, _llm, _beam_width ) ){
+        if( _dcg->leaf_search( phrases, _world, _context, _llm, _beam_width ) ){
           struct timeval end_time;
           gettimeofday( &end_time, NULL );
           comment_string.str( string() );
-          comment_string << "successfully inferred structured language for \"" << sentence << "\" in " << diff_time( start_time, end_time ) << " seconds";
+          comment_string << "successfully inferred structured language for \"" << sentence << "\" from parse tree " << _dcg->parse_index() + 1 << " in " << diff_time( start_time, end_time ) << " seconds (" << _dcg->num_abandoned_parses() << " parse trees abandoned)";
           _text_browser_comments->append( _format_comment( comment_string.str(), false ) );
         } else {
           comment_string.str( string() );
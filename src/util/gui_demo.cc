@@ -71,6 +71,7 @@ main( int argc,
   }
 
   DCG * dcg = new DCG();
+  dcg->solution_cache().size() = args.solution_cache_size_arg;
 
   GUI gui( grammar, parser, world, context, llm, dcg, args.beam_width_arg );
 
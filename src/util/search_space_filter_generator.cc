@@ -0,0 +1,80 @@
+/**
+ * @file    search_space_filter_generator.cc
+ * @author  Thomas M. Howard (tmhoward@csail.mit.edu)
+ *          Matthew R. Walter (mwalter@csail.mit.edu)
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This file is part of h2sl.
+ *
+ * Copyright (C) 2014 by the Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html> or write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @section DESCRIPTION
+ *
+ * A search space filter generation program
+ */
+
+#include <iostream>
+
+#include "h2sl/phrase.h"
+#include "h2sl/search_space_filter.h"
+#include "search_space_filter_generator_cmdline.h"
+
+using namespace std;
+using namespace h2sl;
+
+int
+main( int argc,
+      char* argv[] ) {
+  gengetopt_args_info args;
+  if( cmdline_parser( argc, argv, &args ) != 0 ){
+    exit(1);
+  }
+
+  Search_Space_Filter * search_space_filter = new Search_Space_Filter();
+
+  if( search_space_filter != NULL ){
+    for( unsigned int i = 0; i < args.inputs_num; i++ ){
+      Phrase * phrase = new Phrase();
+      if( phrase != NULL ){
+        phrase->from_xml( args.inputs[ i ] );
+
+        search_space_filter->learn( phrase );
+
+        delete phrase;
+        phrase = NULL;
+      } else {
+        return 1;
+      }
+    }
+
+    cout << "search_space_filter:{" << *search_space_filter << "}" << endl;
+
+    if( args.output_given ){
+      search_space_filter->to_xml( args.output_arg );
+    }
+
+    delete search_space_filter;
+    search_space_filter = NULL;
+    return 0;
+  } else {
+    return 1;
+  }
+}